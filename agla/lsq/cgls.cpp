@@ -0,0 +1,299 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "cgls.hpp"
+#include "../mtx/blas.hpp"
+#include "../mtx/kernels.hpp"
+
+namespace agla::lsq {
+
+	// ########################## Linear Operator ##########################
+
+	template <numeric T> [[nodiscard]] linear_operator<T> linear_operator<T>::from_matrix(const mtx::matrix<T>& a) noexcept {
+		return linear_operator {
+			a.rows_number(),
+			a.columns_number(),
+			[&a](const T* const x, T* const y) {
+				const auto columns = a.columns_number();
+
+				for (std::size_t i = 0; i < a.rows_number(); ++i)
+					y[i] = mtx::kernels::dot(a.get_unchecked(i).data(), x, columns);
+			},
+			[&a](const T* const y, T* const x) {
+				const auto columns = a.columns_number();
+				std::fill(x, x + columns, T(0));
+
+				for (std::size_t i = 0; i < a.rows_number(); ++i)
+					mtx::kernels::axpy(y[i], a.get_unchecked(i).data(), x, columns);
+			}
+		};
+	}
+
+	// ########################## Preconditioner ##########################
+
+	template <numeric T> [[nodiscard]] preconditioner<T> preconditioner<T>::identity() noexcept {
+		return preconditioner { [](T*) {}, [](T*) {} };
+	}
+
+	template <numeric T> [[nodiscard]] preconditioner<T> preconditioner<T>::jacobi(std::vector<T> column_norms) noexcept {
+		for (auto& norm : column_norms)
+			norm = norm == 0 ? T(1) : T(1) / norm;
+
+		const auto inv_norms = std::make_shared<const std::vector<T>>(std::move(column_norms));
+
+		const auto scale = [inv_norms](T* const x) {
+			for (std::size_t i = 0; i < inv_norms->size(); ++i)
+				x[i] *= (*inv_norms)[i];
+		};
+
+		return preconditioner { scale, scale };
+	}
+
+	template <numeric T> [[nodiscard]] preconditioner<T> preconditioner<T>::jacobi(const mtx::matrix<T>& a) noexcept {
+		const auto columns = a.columns_number();
+		std::vector<T> norms(columns, 0);
+
+		for (std::size_t i = 0; i < a.rows_number(); ++i) {
+			const auto* const row = a.get_unchecked(i).data();
+
+			for (std::size_t q = 0; q < columns; ++q)
+				norms[q] += row[q] * row[q];
+		}
+
+		for (auto& norm : norms)
+			norm = std::sqrt(norm);
+
+		return jacobi(std::move(norms));
+	}
+
+	template <numeric T> [[nodiscard]] preconditioner<T> preconditioner<T>::incomplete_cholesky(
+		const mtx::square_matrix<T>& gram,
+		const T drop_tolerance
+	) noexcept {
+		struct sparse_lower {
+			std::vector<std::vector<std::pair<std::size_t, T>>> rows;
+			std::vector<T> diagonal;
+		};
+
+		const auto size = gram.size();
+		auto factor = std::make_shared<sparse_lower>();
+		std::vector<T> work(size);
+
+		constexpr std::size_t max_attempts = 32;
+
+		// Non-positive or non-finite pivots (zero columns, NaN entries) are replaced by 1, as
+		// jacobi does with zero norms, so the shift below always has something to work with
+		std::vector<T> pivots(size);
+		T largest = 0;
+
+		for (std::size_t i = 0; i < size; ++i) {
+			const auto g = gram.get_unchecked(i).get_unchecked(i);
+			pivots[i] = g > 0 && std::isfinite(g) ? g : T(1);
+			largest = std::max(largest, pivots[i]);
+		}
+
+		// Manteuffel shift: on breakdown retry with a growing fraction of the largest pivot added
+		// to the diagonal. Once the attempts run out the factor is the diagonal alone, which is
+		// the Jacobi scaling by sqrt(g_ii)
+		auto breakdown = true;
+
+		for (std::size_t attempt = 0; attempt < max_attempts && breakdown; ++attempt) {
+			const auto shift = attempt == 0 ? T(0) : largest * std::ldexp(T(1e-3), static_cast<int>(attempt) - 1);
+
+			factor->rows.assign(size, {});
+			factor->diagonal.assign(size, 0);
+			breakdown = false;
+
+			for (std::size_t i = 0; i < size && !breakdown; ++i) {
+				const auto& gram_i = gram.get_unchecked(i);
+				auto& row_i = factor->rows[i];
+				std::fill(work.begin(), work.begin() + i, T(0));
+
+				for (std::size_t q = 0; q < i; ++q) {
+					auto sum = gram_i.get_unchecked(q);
+
+					for (const auto& [k, value] : factor->rows[q])
+						sum -= work[k] * value;
+
+					const auto value = sum / factor->diagonal[q];
+					const auto threshold = drop_tolerance * std::sqrt(pivots[i] * pivots[q]);
+
+					if (value != 0 && std::abs(value) >= threshold) {
+						work[q] = value;
+						row_i.emplace_back(q, value);
+					}
+				}
+
+				auto diag = pivots[i] + shift;
+
+				for (const auto& [k, value] : row_i)
+					diag -= value * value;
+
+				if (!(diag > 0) || !std::isfinite(diag)) {
+					breakdown = true;
+					continue;
+				}
+
+				factor->diagonal[i] = std::sqrt(diag);
+			}
+		}
+
+		if (breakdown) {
+			factor->rows.assign(size, {});
+
+			for (std::size_t i = 0; i < size; ++i)
+				factor->diagonal[i] = std::sqrt(pivots[i]);
+		}
+
+		return preconditioner {
+			[factor](T* const x) {
+				for (std::size_t i = factor->rows.size(); i-- > 0;) {
+					x[i] /= factor->diagonal[i];
+
+					for (const auto& [k, value] : factor->rows[i])
+						x[k] -= value * x[i];
+				}
+			},
+			[factor](T* const x) {
+				for (std::size_t i = 0; i < factor->rows.size(); ++i) {
+					auto sum = x[i];
+
+					for (const auto& [k, value] : factor->rows[i])
+						sum -= value * x[k];
+
+					x[i] = sum / factor->diagonal[i];
+				}
+			}
+		};
+	}
+
+	// ########################## CGLS ##########################
+
+	template <numeric T> [[nodiscard]] std::optional<cgls_result<T>> cgls(
+		const linear_operator<T>& a,
+		const mtx::column_vector<T>& b,
+		const preconditioner<T>& m,
+		const cgls_options<T>& options,
+		const std::optional<mtx::column_vector<T>>& warm_start
+	) noexcept {
+		const auto rows = a.rows;
+		const auto columns = a.columns;
+
+		if (b.size() != rows || (warm_start.has_value() && warm_start->size() != columns))
+			return std::nullopt;
+
+		std::vector<T> x(columns, 0), r(rows), s(columns), p(columns), t(columns), q(rows);
+
+		if (warm_start.has_value())
+			for (std::size_t i = 0; i < columns; ++i)
+				x[i] = warm_start->get_unchecked(i);
+
+		a.apply(x.data(), q.data());
+
+		for (std::size_t i = 0; i < rows; ++i)
+			r[i] = b.get_unchecked(i) - q[i];
+
+		a.apply_transposed(r.data(), s.data());
+		m.solve_transposed(s.data());
+
+		std::copy(s.begin(), s.end(), p.begin());
+
+		auto gamma = mtx::kernels::sum_of_squares(s.data(), columns);
+		auto threshold = options.tolerance * std::sqrt(gamma);
+
+		// Tolerance stays relative to the cold-start residual, so warm starts can stop early
+		if (warm_start.has_value()) {
+			for (std::size_t i = 0; i < rows; ++i)
+				q[i] = b.get_unchecked(i);
+
+			a.apply_transposed(q.data(), t.data());
+			m.solve_transposed(t.data());
+			threshold = options.tolerance * std::sqrt(mtx::kernels::sum_of_squares(t.data(), columns));
+		}
+
+		cgls_result<T> result { mtx::column_vector<T>(columns), 0, std::sqrt(gamma) <= threshold, 0, std::sqrt(gamma) };
+
+		while (!result.converged && result.iterations < options.max_iterations) {
+			std::copy(p.begin(), p.end(), t.begin());
+			m.solve(t.data());
+			a.apply(t.data(), q.data());
+
+			const auto q_norm = mtx::kernels::sum_of_squares(q.data(), rows);
+			if (q_norm == 0) break;
+
+			const auto alpha = gamma / q_norm;
+			mtx::kernels::axpy(alpha, t.data(), x.data(), columns);
+			mtx::kernels::axpy(-alpha, q.data(), r.data(), rows);
+
+			a.apply_transposed(r.data(), s.data());
+			m.solve_transposed(s.data());
+
+			const auto gamma_next = mtx::kernels::sum_of_squares(s.data(), columns);
+			const auto beta = gamma_next / gamma;
+			gamma = gamma_next;
+
+			for (std::size_t i = 0; i < columns; ++i)
+				p[i] = s[i] + beta * p[i];
+
+			++result.iterations;
+			result.normal_residual_norm = std::sqrt(gamma);
+			result.converged = result.normal_residual_norm <= threshold;
+		}
+
+		for (std::size_t i = 0; i < columns; ++i)
+			result.x.get_unchecked(i) = x[i];
+
+		result.residual_norm = mtx::blas::nrm2(r.data(), rows);
+		return std::make_optional(std::move(result));
+	}
+
+	// ########################## Linear Operator ##########################
+
+	template linear_operator<double> linear_operator<double>::from_matrix(const mtx::matrix<double>& a) noexcept;
+	template linear_operator<float> linear_operator<float>::from_matrix(const mtx::matrix<float>& a) noexcept;
+	template linear_operator<long double> linear_operator<long double>::from_matrix(const mtx::matrix<long double>& a) noexcept;
+
+	// ########################## Preconditioner ##########################
+
+	template preconditioner<double> preconditioner<double>::identity() noexcept;
+	template preconditioner<double> preconditioner<double>::jacobi(std::vector<double> column_norms) noexcept;
+	template preconditioner<double> preconditioner<double>::jacobi(const mtx::matrix<double>& a) noexcept;
+	template preconditioner<double> preconditioner<double>::incomplete_cholesky(const mtx::square_matrix<double>& gram, double drop_tolerance) noexcept;
+
+	template preconditioner<float> preconditioner<float>::identity() noexcept;
+	template preconditioner<float> preconditioner<float>::jacobi(std::vector<float> column_norms) noexcept;
+	template preconditioner<float> preconditioner<float>::jacobi(const mtx::matrix<float>& a) noexcept;
+	template preconditioner<float> preconditioner<float>::incomplete_cholesky(const mtx::square_matrix<float>& gram, float drop_tolerance) noexcept;
+
+	template preconditioner<long double> preconditioner<long double>::identity() noexcept;
+	template preconditioner<long double> preconditioner<long double>::jacobi(std::vector<long double> column_norms) noexcept;
+	template preconditioner<long double> preconditioner<long double>::jacobi(const mtx::matrix<long double>& a) noexcept;
+	template preconditioner<long double> preconditioner<long double>::incomplete_cholesky(const mtx::square_matrix<long double>& gram, long double drop_tolerance) noexcept;
+
+	// ########################## CGLS ##########################
+
+	template std::optional<cgls_result<double>> cgls(
+		const linear_operator<double>& a,
+		const mtx::column_vector<double>& b,
+		const preconditioner<double>& m,
+		const cgls_options<double>& options,
+		const std::optional<mtx::column_vector<double>>& warm_start
+	) noexcept;
+
+	template std::optional<cgls_result<float>> cgls(
+		const linear_operator<float>& a,
+		const mtx::column_vector<float>& b,
+		const preconditioner<float>& m,
+		const cgls_options<float>& options,
+		const std::optional<mtx::column_vector<float>>& warm_start
+	) noexcept;
+
+	template std::optional<cgls_result<long double>> cgls(
+		const linear_operator<long double>& a,
+		const mtx::column_vector<long double>& b,
+		const preconditioner<long double>& m,
+		const cgls_options<long double>& options,
+		const std::optional<mtx::column_vector<long double>>& warm_start
+	) noexcept;
+} // agla::lsq
@@ -0,0 +1,67 @@
+#ifndef CGLS_HPP
+#define CGLS_HPP
+
+#include <functional>
+
+#include "../mtx/column_vector.hpp"
+
+namespace agla::lsq {
+
+	// ########################## Linear Operator ##########################
+
+	template <numeric T> struct linear_operator {
+		std::size_t rows;
+		std::size_t columns;
+
+		std::function<void(const T* x, T* y)> apply;
+		std::function<void(const T* y, T* x)> apply_transposed;
+
+		// Captures the matrix by reference; it must outlive the operator
+		[[nodiscard]] static linear_operator from_matrix(const mtx::matrix<T>& a) noexcept;
+	};
+
+	// ########################## Preconditioner ##########################
+
+	// Right preconditioner M for min ||A * M^-1 * y - b||, applied in place
+	template <numeric T> struct preconditioner {
+		std::function<void(T* x)> solve;
+		std::function<void(T* x)> solve_transposed;
+
+		[[nodiscard]] static preconditioner identity() noexcept;
+
+		[[nodiscard]] static preconditioner jacobi(std::vector<T> column_norms) noexcept;
+		[[nodiscard]] static preconditioner jacobi(const mtx::matrix<T>& a) noexcept;
+
+		// M = L^T, where L * L^T approximates the given Gram matrix with entries
+		// below drop_tolerance * sqrt(g_ii * g_jj) discarded. Breakdowns are retried a bounded
+		// number of times with a growing diagonal shift, after which M falls back to diag(sqrt(g_ii));
+		// zero, negative or non-finite g_ii count as 1
+		[[nodiscard]] static preconditioner incomplete_cholesky(const mtx::square_matrix<T>& gram, T drop_tolerance) noexcept;
+	};
+
+	// ########################## CGLS ##########################
+
+	template <numeric T> struct cgls_options {
+		std::size_t max_iterations = 1000;
+		T tolerance = 1e-6;
+	};
+
+	template <numeric T> struct cgls_result {
+		mtx::column_vector<T> x;
+		std::size_t iterations;
+		bool converged;
+		T residual_norm;
+		T normal_residual_norm;
+	};
+
+	// Returns nullopt when b does not have a.rows elements or the warm start a.columns
+	template <numeric T> [[nodiscard]] std::optional<cgls_result<T>> cgls(
+		const linear_operator<T>& a,
+		const mtx::column_vector<T>& b,
+		const preconditioner<T>& m = preconditioner<T>::identity(),
+		const cgls_options<T>& options = {},
+		const std::optional<mtx::column_vector<T>>& warm_start = std::nullopt
+	) noexcept;
+} // agla::lsq
+
+#endif // CGLS_HPP
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <functional>
+
+#include "factorization_cache.hpp"
+
+namespace agla::lsq {
+	namespace {
+		template <numeric T> [[nodiscard]] std::size_t grid_hash(const std::vector<T>& x, const std::size_t degree, const basis kind) noexcept {
+			std::size_t seed = x.size() * 0x9E3779B97F4A7C15ull ^ degree << 8 ^ static_cast<std::size_t>(kind);
+
+			// boost::hash_combine; std::hash maps 0.0 and -0.0 alike, matching == below
+			for (const auto value : x)
+				seed ^= std::hash<T> {}(value) + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2);
+
+			return seed;
+		}
+	}
+
+	template <numeric T> factorization_cache<T>::factorization_cache(
+		const std::size_t capacity,
+		const std::size_t max_bytes,
+		const least_squares_options<T>& options
+	) noexcept : capacity(std::max<std::size_t>(capacity, 1)), max_bytes(max_bytes), options(options) {}
+
+	template <numeric T> [[nodiscard]] typename factorization_cache<T>::entry_iterator factorization_cache<T>::find(
+		const std::size_t hash,
+		const std::vector<T>& x,
+		const std::size_t degree,
+		const basis kind
+	) noexcept {
+		const auto [begin, end] = index.equal_range(hash);
+
+		for (auto it = begin; it != end; ++it) {
+			const auto& e = *it->second;
+
+			if (e.degree == degree && e.kind == kind && e.x == x)
+				return it->second;
+		}
+
+		return entries.end();
+	}
+
+	template <numeric T> [[nodiscard]] std::shared_ptr<const least_squares_factorization<T>> factorization_cache<T>::get(
+		const std::vector<T>& x,
+		const std::size_t degree,
+		const basis kind
+	) noexcept {
+		if (x.size() <= degree)
+			return nullptr;
+
+		const auto hash = grid_hash(x, degree, kind);
+
+		{
+			std::lock_guard lock(mutex);
+
+			if (const auto it = find(hash, x, degree, kind); it != entries.end()) {
+				++hits;
+				entries.splice(entries.begin(), entries, it);
+				return it->factorization;
+			}
+
+			++misses;
+		}
+
+		auto factorization = least_squares_factorization<T>::from_matrix(design_matrix(x, degree, kind), options);
+
+		if (!factorization.has_value())
+			return nullptr;
+
+		auto built = std::make_shared<const least_squares_factorization<T>>(std::move(*factorization));
+		const auto entry_bytes = built->footprint() + x.size() * sizeof(T);
+
+		if (entry_bytes > max_bytes)
+			return built;
+
+		std::lock_guard lock(mutex);
+
+		// Another thread may have built the same grid meanwhile; keep the first one
+		if (const auto it = find(hash, x, degree, kind); it != entries.end()) {
+			entries.splice(entries.begin(), entries, it);
+			return it->factorization;
+		}
+
+		entries.push_front(entry { hash, degree, kind, x, built, entry_bytes });
+		index.emplace(hash, entries.begin());
+		bytes += entry_bytes;
+
+		// The new entry fits the byte bound on its own, so it is never the one evicted
+		while (entries.size() > capacity || bytes > max_bytes) {
+			const auto last = std::prev(entries.end());
+			const auto [begin, end] = index.equal_range(last->hash);
+
+			for (auto it = begin; it != end; ++it) {
+				if (it->second == last) {
+					index.erase(it);
+					break;
+				}
+			}
+
+			bytes -= last->bytes;
+			entries.pop_back();
+			++evictions;
+		}
+
+		return built;
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<least_squares_solution<T>> factorization_cache<T>::fit(
+		const std::vector<T>& x,
+		const mtx::column_vector<T>& y,
+		const std::size_t degree,
+		const basis kind
+	) noexcept {
+		if (y.size() != x.size())
+			return std::nullopt;
+
+		const auto factorization = get(x, degree, kind);
+
+		if (factorization == nullptr)
+			return std::nullopt;
+
+		return factorization->solve(y);
+	}
+
+	template <numeric T> [[nodiscard]] cache_statistics factorization_cache<T>::statistics() const noexcept {
+		std::lock_guard lock(mutex);
+		return cache_statistics { hits, misses, evictions, entries.size(), bytes };
+	}
+
+	template <numeric T> void factorization_cache<T>::clear() noexcept {
+		std::lock_guard lock(mutex);
+		index.clear();
+		entries.clear();
+		hits = misses = evictions = bytes = 0;
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	template factorization_cache<double>::factorization_cache(std::size_t capacity, std::size_t max_bytes, const least_squares_options<double>& options) noexcept;
+	template factorization_cache<float>::factorization_cache(std::size_t capacity, std::size_t max_bytes, const least_squares_options<float>& options) noexcept;
+	template factorization_cache<long double>::factorization_cache(std::size_t capacity, std::size_t max_bytes, const least_squares_options<long double>& options) noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template std::shared_ptr<const least_squares_factorization<double>> factorization_cache<double>::get(const std::vector<double>& x, std::size_t degree, basis kind) noexcept;
+	template std::shared_ptr<const least_squares_factorization<float>> factorization_cache<float>::get(const std::vector<float>& x, std::size_t degree, basis kind) noexcept;
+	template std::shared_ptr<const least_squares_factorization<long double>> factorization_cache<long double>::get(const std::vector<long double>& x, std::size_t degree, basis kind) noexcept;
+
+	template std::optional<least_squares_solution<double>> factorization_cache<double>::fit(
+		const std::vector<double>& x,
+		const mtx::column_vector<double>& y,
+		std::size_t degree,
+		basis kind
+	) noexcept;
+
+	template std::optional<least_squares_solution<float>> factorization_cache<float>::fit(
+		const std::vector<float>& x,
+		const mtx::column_vector<float>& y,
+		std::size_t degree,
+		basis kind
+	) noexcept;
+
+	template std::optional<least_squares_solution<long double>> factorization_cache<long double>::fit(
+		const std::vector<long double>& x,
+		const mtx::column_vector<long double>& y,
+		std::size_t degree,
+		basis kind
+	) noexcept;
+
+	template cache_statistics factorization_cache<double>::statistics() const noexcept;
+	template cache_statistics factorization_cache<float>::statistics() const noexcept;
+	template cache_statistics factorization_cache<long double>::statistics() const noexcept;
+
+	template void factorization_cache<double>::clear() noexcept;
+	template void factorization_cache<float>::clear() noexcept;
+	template void factorization_cache<long double>::clear() noexcept;
+} // agla::lsq
@@ -0,0 +1,90 @@
+#ifndef FACTORIZATION_CACHE_HPP
+#define FACTORIZATION_CACHE_HPP
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "least_squares.hpp"
+
+namespace agla::lsq {
+	struct cache_statistics {
+		std::size_t hits;
+		std::size_t misses;
+		std::size_t evictions;
+		std::size_t entries;
+
+		// Held by the cached factorizations and their keys, see least_squares_factorization::footprint
+		std::size_t bytes;
+	};
+
+	// LRU of least-squares factorizations keyed by the abscissae, degree and basis, so fitting
+	// another series on a known grid is one O(rows * columns) solve. Bounded by both the number of
+	// entries and their bytes, as QR and normal equations entries keep O(rows * columns) data;
+	// a factorization larger than the byte bound on its own is returned without being cached.
+	// Keys are hashed and then compared by value, so colliding grids never share a factorization.
+	// Thread-safe; factorizations are built outside the lock and handed out as shared immutable objects
+	template <numeric T> class factorization_cache {
+		struct entry {
+			std::size_t hash;
+			std::size_t degree;
+			basis kind;
+			std::vector<T> x;
+			std::shared_ptr<const least_squares_factorization<T>> factorization;
+			std::size_t bytes;
+		};
+
+		using entry_iterator = typename std::list<entry>::iterator;
+
+		std::size_t capacity;
+		std::size_t max_bytes;
+		least_squares_options<T> options;
+
+		mutable std::mutex mutex;
+
+		// Most recently used first
+		std::list<entry> entries;
+		std::unordered_multimap<std::size_t, entry_iterator> index;
+
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+		std::size_t evictions = 0;
+		std::size_t bytes = 0;
+
+		[[nodiscard]] entry_iterator find(std::size_t hash, const std::vector<T>& x, std::size_t degree, basis kind) noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		explicit factorization_cache(
+			std::size_t capacity = 64,
+			std::size_t max_bytes = std::size_t(256) << 20,
+			const least_squares_options<T>& options = {}
+		) noexcept;
+
+		factorization_cache(const factorization_cache&) = delete;
+		factorization_cache& operator=(const factorization_cache&) = delete;
+
+		// ----------------------- Operations -----------------------
+
+		// Factorization of design_matrix(x, degree, kind); null when there are fewer points than coefficients
+		[[nodiscard]] std::shared_ptr<const least_squares_factorization<T>> get(const std::vector<T>& x, std::size_t degree, basis kind = basis::monomial) noexcept;
+
+		// Returns nullopt when y does not match x or the fit is underdetermined
+		[[nodiscard]] std::optional<least_squares_solution<T>> fit(
+			const std::vector<T>& x,
+			const mtx::column_vector<T>& y,
+			std::size_t degree,
+			basis kind = basis::monomial
+		) noexcept;
+
+		[[nodiscard]] cache_statistics statistics() const noexcept;
+
+		// Drops every entry and zeroes the statistics
+		void clear() noexcept;
+	};
+} // agla::lsq
+
+#endif // FACTORIZATION_CACHE_HPP
@@ -0,0 +1,367 @@
+#include <algorithm>
+
+#include "least_squares.hpp"
+#include "../mtx/kernels.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::lsq {
+	namespace {
+		template <numeric T> mtx::column_vector<T> to_column_vector(const std::vector<T>& buf, const std::size_t size) noexcept {
+			mtx::column_vector<T> result(size);
+
+			for (std::size_t i = 0; i < size; ++i)
+				result.get_unchecked(i) = buf[i];
+
+			return result;
+		}
+	}
+
+	[[nodiscard]] const char* name(const solver method) noexcept {
+		switch (method) {
+			case solver::normal_equations: return "normal equations (Cholesky)";
+			case solver::qr: return "Householder QR";
+			case solver::svd: return "QR + Jacobi SVD";
+		}
+
+		return "unknown";
+	}
+
+	template <numeric T> inline void design_row(const T x, const std::size_t degree, const basis kind, T* const row) noexcept {
+		row[0] = 1;
+
+		if (kind == basis::monomial) {
+			for (std::size_t k = 1; k <= degree; ++k)
+				row[k] = row[k - 1] * x;
+
+			return;
+		}
+
+		// T_0 = 1, T_1 = x, T_k+1 = 2 * x * T_k - T_k-1
+		if (degree > 0)
+			row[1] = x;
+
+		for (std::size_t k = 2; k <= degree; ++k)
+			row[k] = 2 * x * row[k - 1] - row[k - 2];
+	}
+
+	template <numeric T> [[nodiscard]] mtx::matrix<T> vandermonde(const std::vector<T>& x, const std::size_t degree) noexcept {
+		return design_matrix(x, degree, basis::monomial);
+	}
+
+	template <numeric T> [[nodiscard]] mtx::matrix<T> design_matrix(const std::vector<T>& x, const std::size_t degree, const basis kind) noexcept {
+		mtx::matrix<T> result(x.size(), degree + 1);
+
+		for (std::size_t i = 0; i < x.size(); ++i)
+			design_row(x[i], degree, kind, result.get_unchecked(i).data());
+
+		return result;
+	}
+
+	// ########################## Factorization ##########################
+
+	template <numeric T> least_squares_factorization<T>::least_squares_factorization(const std::size_t rows, const std::size_t columns) noexcept
+		: rows(rows), columns(columns), chosen(solver::qr), condition(0), numerical_rank(columns), tolerance(0) {}
+
+	template <numeric T> [[nodiscard]] std::optional<least_squares_factorization<T>> least_squares_factorization<T>::from_matrix(
+		const mtx::matrix<T>& a,
+		const least_squares_options<T>& options
+	) noexcept {
+		const auto m = a.rows_number();
+		const auto n = a.columns_number();
+
+		if (m < n)
+			return std::nullopt;
+
+		constexpr auto unbounded = std::numeric_limits<T>::infinity();
+
+		// Forcing lifts the condition limits but still needs a finite estimate: an infinite or NaN
+		// one means a singular factor whose solve would hand back inf or NaN
+		constexpr auto largest = std::numeric_limits<T>::max();
+		const auto forced = options.force.has_value();
+		least_squares_factorization result(m, n);
+
+		// ----------------------- Normal equations -----------------------
+
+		if (!forced || *options.force == solver::normal_equations) {
+			auto gram = mtx::square_matrix<T>::from_matrix_unchecked(a.transposed_view().mul_unchecked(a));
+			const auto gram_norm = gram.one_norm();
+			auto factor = mtx::cholesky_decomposition<T>::from_square_matrix(std::move(gram));
+			const auto condition = factor.has_value() ? factor->condition_estimate(gram_norm) : unbounded;
+
+			if (factor.has_value() && condition <= (forced ? largest : options.max_normal_condition)) {
+				result.design.emplace(a);
+				result.normal = std::move(factor);
+				result.chosen = solver::normal_equations;
+				result.condition = std::sqrt(condition);
+				return std::make_optional(std::move(result));
+			}
+		}
+
+		// ----------------------- QR -----------------------
+
+		result.qr = mtx::qr_decomposition<T>::from_matrix(a);
+		result.condition = result.qr->condition_estimate();
+
+		if (options.force != solver::svd && result.condition <= (forced ? largest : options.max_qr_condition))
+			return std::make_optional(std::move(result));
+
+		// ----------------------- SVD -----------------------
+
+		// R has the singular values of A and Q^T * b carries everything but the residual
+		result.svd = mtx::singular_value_decomposition<T>::from_matrix(result.qr->upper_triangular());
+
+		// Only non-finite entries in A leave the singular values unusable
+		if (!result.svd.has_value() || !std::ranges::all_of(result.svd->singular_values(), [](const T value) { return std::isfinite(value); }))
+			return std::nullopt;
+
+		result.tolerance = options.rank_tolerance > 0 ? options.rank_tolerance : static_cast<T>(m) * std::numeric_limits<T>::epsilon();
+		result.chosen = solver::svd;
+		result.condition = result.svd->condition_number();
+		result.numerical_rank = result.svd->rank(result.tolerance);
+		return std::make_optional(std::move(result));
+	}
+
+	template <numeric T> inline std::size_t least_squares_factorization<T>::rows_number() const noexcept { return rows; }
+	template <numeric T> inline std::size_t least_squares_factorization<T>::columns_number() const noexcept { return columns; }
+	template <numeric T> inline solver least_squares_factorization<T>::method() const noexcept { return chosen; }
+	template <numeric T> inline T least_squares_factorization<T>::condition_estimate() const noexcept { return condition; }
+	template <numeric T> inline std::size_t least_squares_factorization<T>::rank() const noexcept { return numerical_rank; }
+
+	template <numeric T> inline std::size_t least_squares_factorization<T>::footprint() const noexcept {
+		std::size_t elements = 0;
+
+		if (design.has_value())
+			elements += rows * columns;
+
+		if (normal.has_value())
+			elements += columns * columns;
+
+		// Reflectors plus the diagonal and scales
+		if (qr.has_value())
+			elements += rows * columns + 2 * columns;
+
+		// U, V and the singular values of the columns x columns R
+		if (svd.has_value())
+			elements += 2 * columns * columns + columns;
+
+		return elements * sizeof(T);
+	}
+
+	template <numeric T> inline void least_squares_factorization<T>::solve_unchecked(const T* const b, T* const x) const noexcept {
+		if (chosen == solver::normal_equations) {
+			std::fill_n(x, columns, T(0));
+
+			// A^T * b accumulated row by row, as A is stored by rows
+			for (std::size_t i = 0; i < rows; ++i)
+				mtx::kernels::axpy(b[i], design->get_unchecked(i).data(), x, columns);
+
+			normal->solve_in_place(x);
+			return;
+		}
+
+		std::vector<T> buf(b, b + rows);
+		qr->apply_transposed_q(buf.data());
+
+		if (chosen == solver::qr)
+			qr->solve_upper_in_place(buf.data());
+		else
+			svd->solve_in_place(buf.data(), tolerance);
+
+		std::copy_n(buf.begin(), columns, x);
+	}
+
+	template <numeric T> [[nodiscard]] inline std::optional<least_squares_solution<T>> least_squares_factorization<T>::solve(
+		const mtx::column_vector<T>& b
+	) const noexcept {
+		if (b.size() != rows)
+			return std::nullopt;
+
+		std::vector<T> buf(rows);
+		std::vector<T> x(columns);
+
+		for (std::size_t i = 0; i < rows; ++i)
+			buf[i] = b.get_unchecked(i);
+
+		solve_unchecked(buf.data(), x.data());
+		return std::make_optional(least_squares_solution<T> { to_column_vector(x, columns), chosen, condition, numerical_rank });
+	}
+
+	template <numeric T> [[nodiscard]] inline std::optional<mtx::matrix<T>> least_squares_factorization<T>::solve(
+		const mtx::matrix<T>& b
+	) const noexcept {
+		if (b.rows_number() != rows)
+			return std::nullopt;
+
+		const auto count = b.columns_number();
+		auto& pool = par::thread_pool::instance();
+
+		// One right-hand side per row, so every system works on contiguous memory
+		auto systems = chosen == solver::normal_equations ? b.transposed_view().mul_unchecked(*design) : b.transposed();
+
+		pool.parallel_for(0, count, par::thread_pool::grain_for(rows * columns), [&](const std::size_t from, const std::size_t to) {
+			if (chosen == solver::normal_equations) {
+				for (std::size_t j = from; j < to; ++j)
+					normal->solve_in_place(systems.get_unchecked(j).data());
+
+				return;
+			}
+
+			std::vector<T*> block(to - from);
+
+			for (std::size_t j = from; j < to; ++j)
+				block[j - from] = systems.get_unchecked(j).data();
+
+			qr->apply_transposed_q(block.data(), block.size());
+
+			for (auto* const system : block) {
+				if (chosen == solver::qr)
+					qr->solve_upper_in_place(system);
+				else
+					svd->solve_in_place(system, tolerance);
+			}
+		});
+
+		mtx::matrix<T> result(columns, count, b.get_allocator());
+
+		for (std::size_t j = 0; j < count; ++j) {
+			const auto* const system = systems.get_unchecked(j).data();
+
+			for (std::size_t i = 0; i < columns; ++i)
+				result.get_unchecked(i).get_unchecked(j) = system[i];
+		}
+
+		return std::make_optional(std::move(result));
+	}
+
+	// ########################## Least squares ##########################
+
+	template <numeric T> [[nodiscard]] std::optional<least_squares_solution<T>> least_squares(
+		const mtx::matrix<T>& a,
+		const mtx::column_vector<T>& b,
+		const least_squares_options<T>& options
+	) noexcept {
+		if (b.size() != a.rows_number())
+			return std::nullopt;
+
+		const auto factorization = least_squares_factorization<T>::from_matrix(a, options);
+
+		if (!factorization.has_value())
+			return std::nullopt;
+
+		return factorization->solve(b);
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<least_squares_matrix_solution<T>> least_squares(
+		const mtx::matrix<T>& a,
+		const mtx::matrix<T>& b,
+		const least_squares_options<T>& options
+	) noexcept {
+		if (b.rows_number() != a.rows_number())
+			return std::nullopt;
+
+		const auto factorization = least_squares_factorization<T>::from_matrix(a, options);
+
+		if (!factorization.has_value())
+			return std::nullopt;
+
+		return std::make_optional(least_squares_matrix_solution<T> {
+			factorization->solve(b).value(),
+			factorization->method(),
+			factorization->condition_estimate(),
+			factorization->rank()
+		});
+	}
+
+	template void design_row(double x, std::size_t degree, basis kind, double* row) noexcept;
+	template void design_row(float x, std::size_t degree, basis kind, float* row) noexcept;
+	template void design_row(long double x, std::size_t degree, basis kind, long double* row) noexcept;
+
+	template mtx::matrix<double> vandermonde(const std::vector<double>& x, std::size_t degree) noexcept;
+	template mtx::matrix<float> vandermonde(const std::vector<float>& x, std::size_t degree) noexcept;
+	template mtx::matrix<long double> vandermonde(const std::vector<long double>& x, std::size_t degree) noexcept;
+
+	template mtx::matrix<double> design_matrix(const std::vector<double>& x, std::size_t degree, basis kind) noexcept;
+	template mtx::matrix<float> design_matrix(const std::vector<float>& x, std::size_t degree, basis kind) noexcept;
+	template mtx::matrix<long double> design_matrix(const std::vector<long double>& x, std::size_t degree, basis kind) noexcept;
+
+	template std::optional<least_squares_factorization<double>> least_squares_factorization<double>::from_matrix(
+		const mtx::matrix<double>& a,
+		const least_squares_options<double>& options
+	) noexcept;
+
+	template std::optional<least_squares_factorization<float>> least_squares_factorization<float>::from_matrix(
+		const mtx::matrix<float>& a,
+		const least_squares_options<float>& options
+	) noexcept;
+
+	template std::optional<least_squares_factorization<long double>> least_squares_factorization<long double>::from_matrix(
+		const mtx::matrix<long double>& a,
+		const least_squares_options<long double>& options
+	) noexcept;
+
+	template std::size_t least_squares_factorization<double>::rows_number() const noexcept;
+	template std::size_t least_squares_factorization<double>::columns_number() const noexcept;
+	template solver least_squares_factorization<double>::method() const noexcept;
+	template double least_squares_factorization<double>::condition_estimate() const noexcept;
+	template std::size_t least_squares_factorization<double>::rank() const noexcept;
+	template std::size_t least_squares_factorization<double>::footprint() const noexcept;
+	template void least_squares_factorization<double>::solve_unchecked(const double* b, double* x) const noexcept;
+	template std::optional<least_squares_solution<double>> least_squares_factorization<double>::solve(const mtx::column_vector<double>& b) const noexcept;
+	template std::optional<mtx::matrix<double>> least_squares_factorization<double>::solve(const mtx::matrix<double>& b) const noexcept;
+
+	template std::size_t least_squares_factorization<float>::rows_number() const noexcept;
+	template std::size_t least_squares_factorization<float>::columns_number() const noexcept;
+	template solver least_squares_factorization<float>::method() const noexcept;
+	template float least_squares_factorization<float>::condition_estimate() const noexcept;
+	template std::size_t least_squares_factorization<float>::rank() const noexcept;
+	template std::size_t least_squares_factorization<float>::footprint() const noexcept;
+	template void least_squares_factorization<float>::solve_unchecked(const float* b, float* x) const noexcept;
+	template std::optional<least_squares_solution<float>> least_squares_factorization<float>::solve(const mtx::column_vector<float>& b) const noexcept;
+	template std::optional<mtx::matrix<float>> least_squares_factorization<float>::solve(const mtx::matrix<float>& b) const noexcept;
+
+	template std::size_t least_squares_factorization<long double>::rows_number() const noexcept;
+	template std::size_t least_squares_factorization<long double>::columns_number() const noexcept;
+	template solver least_squares_factorization<long double>::method() const noexcept;
+	template long double least_squares_factorization<long double>::condition_estimate() const noexcept;
+	template std::size_t least_squares_factorization<long double>::rank() const noexcept;
+	template std::size_t least_squares_factorization<long double>::footprint() const noexcept;
+	template void least_squares_factorization<long double>::solve_unchecked(const long double* b, long double* x) const noexcept;
+	template std::optional<least_squares_solution<long double>> least_squares_factorization<long double>::solve(const mtx::column_vector<long double>& b) const noexcept;
+	template std::optional<mtx::matrix<long double>> least_squares_factorization<long double>::solve(const mtx::matrix<long double>& b) const noexcept;
+
+	template std::optional<least_squares_solution<double>> least_squares(
+		const mtx::matrix<double>& a,
+		const mtx::column_vector<double>& b,
+		const least_squares_options<double>& options
+	) noexcept;
+
+	template std::optional<least_squares_matrix_solution<double>> least_squares(
+		const mtx::matrix<double>& a,
+		const mtx::matrix<double>& b,
+		const least_squares_options<double>& options
+	) noexcept;
+
+	template std::optional<least_squares_solution<float>> least_squares(
+		const mtx::matrix<float>& a,
+		const mtx::column_vector<float>& b,
+		const least_squares_options<float>& options
+	) noexcept;
+
+	template std::optional<least_squares_matrix_solution<float>> least_squares(
+		const mtx::matrix<float>& a,
+		const mtx::matrix<float>& b,
+		const least_squares_options<float>& options
+	) noexcept;
+
+	template std::optional<least_squares_solution<long double>> least_squares(
+		const mtx::matrix<long double>& a,
+		const mtx::column_vector<long double>& b,
+		const least_squares_options<long double>& options
+	) noexcept;
+
+	template std::optional<least_squares_matrix_solution<long double>> least_squares(
+		const mtx::matrix<long double>& a,
+		const mtx::matrix<long double>& b,
+		const least_squares_options<long double>& options
+	) noexcept;
+} // agla::lsq
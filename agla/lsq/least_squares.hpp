@@ -0,0 +1,146 @@
+#ifndef LEAST_SQUARES_HPP
+#define LEAST_SQUARES_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "../mtx/cholesky_decomposition.hpp"
+#include "../mtx/qr_decomposition.hpp"
+#include "../mtx/singular_value_decomposition.hpp"
+
+namespace agla::lsq {
+	enum class solver : std::uint8_t {
+		normal_equations,
+		qr,
+		svd
+	};
+
+	[[nodiscard]] const char* name(solver method) noexcept;
+
+	// Polynomial basis of a design matrix; Chebyshev polynomials T_k are far better conditioned
+	// than monomials once the abscissae are mapped into [-1, 1]
+	enum class basis : std::uint8_t {
+		monomial,
+		chebyshev
+	};
+
+	template <numeric T> struct least_squares_options {
+
+		// Normal equations square the condition number, so Cholesky of A^T*A is only
+		// trusted while the estimated kappa_1(A^T*A) stays below this
+		T max_normal_condition = 1 / std::sqrt(std::numeric_limits<T>::epsilon());
+
+		// Householder QR is backward stable until R is numerically singular
+		T max_qr_condition = T(0.01) / std::numeric_limits<T>::epsilon();
+
+		// Singular values below rank_tolerance * sigma_max are dropped;
+		// 0 means max(rows, columns) * epsilon
+		T rank_tolerance = 0;
+
+		// Skips the condition limits, not the safety checks: forced normal equations still fall back
+		// to QR when A^T*A is not numerically positive definite, and forced normal equations or QR
+		// fall back to SVD when the condition estimate is not finite
+		std::optional<solver> force = std::nullopt;
+	};
+
+	template <numeric T> struct least_squares_solution {
+		mtx::column_vector<T> x;
+		solver method;
+
+		// Estimated kappa(A): sqrt of the kappa_1(A^T*A) estimate for normal equations,
+		// the kappa_1(R) estimate for QR and the exact 2-norm one for SVD
+		T condition_estimate;
+		std::size_t rank;
+	};
+
+	// Column j of x fits column j of the right-hand sides
+	template <numeric T> struct least_squares_matrix_solution {
+		mtx::matrix<T> x;
+		solver method;
+		T condition_estimate;
+		std::size_t rank;
+	};
+
+	// Polynomial design matrix, row i = [1, x_i, x_i^2, ..., x_i^degree]
+	template <numeric T> [[nodiscard]] mtx::matrix<T> vandermonde(const std::vector<T>& x, std::size_t degree) noexcept;
+
+	// row = [p_0(x), p_1(x), ..., p_degree(x)] in the given basis
+	template <numeric T> inline void design_row(T x, std::size_t degree, basis kind, T* row) noexcept;
+
+	// Row i = [p_0(x_i), p_1(x_i), ..., p_degree(x_i)] in the given basis
+	template <numeric T> [[nodiscard]] mtx::matrix<T> design_matrix(const std::vector<T>& x, std::size_t degree, basis kind) noexcept;
+
+	// ########################## Factorization ##########################
+
+	// The solver choice and factorization of A, independent of b, so fits sharing A reuse it
+	template <numeric T> class least_squares_factorization {
+
+		// Only the normal equations path keeps A, to form A^T * b
+		std::optional<mtx::matrix<T>> design;
+		std::optional<mtx::cholesky_decomposition<T>> normal;
+		std::optional<mtx::qr_decomposition<T>> qr;
+		std::optional<mtx::singular_value_decomposition<T>> svd;
+
+		std::size_t rows;
+		std::size_t columns;
+		solver chosen;
+		T condition;
+		std::size_t numerical_rank;
+		T tolerance;
+
+		least_squares_factorization(std::size_t rows, std::size_t columns) noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		// Returns nullopt when A has more columns than rows or non-finite entries
+		[[nodiscard]] static std::optional<least_squares_factorization> from_matrix(
+			const mtx::matrix<T>& a,
+			const least_squares_options<T>& options = {}
+		) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t rows_number() const noexcept;
+		[[nodiscard]] inline std::size_t columns_number() const noexcept;
+		[[nodiscard]] inline solver method() const noexcept;
+		[[nodiscard]] inline T condition_estimate() const noexcept;
+		[[nodiscard]] inline std::size_t rank() const noexcept;
+
+		// Bytes of matrix and vector elements held by the kept factors and A, container overhead aside
+		[[nodiscard]] inline std::size_t footprint() const noexcept;
+
+		// ----------------------- Operations -----------------------
+
+		// b has rows_number() elements, x receives columns_number(); O(rows * columns)
+		inline void solve_unchecked(const T* b, T* x) const noexcept;
+
+		// Returns nullopt when b does not match A
+		[[nodiscard]] inline std::optional<least_squares_solution<T>> solve(const mtx::column_vector<T>& b) const noexcept;
+
+		// All columns of B at once: one B^T * A product for the normal equations, one pass of the
+		// reflectors over all right-hand sides for QR and SVD; the k systems are solved in parallel.
+		// Returns the columns_number() x k coefficient matrix, nullopt when B does not match A
+		[[nodiscard]] inline std::optional<mtx::matrix<T>> solve(const mtx::matrix<T>& b) const noexcept;
+	};
+
+	// argmin ||A * x - b|| through the cheapest of Cholesky on the normal equations, QR and SVD
+	// whose accuracy the condition estimate still allows. Returns nullopt when b does not match
+	// A, A has more columns than rows or A has non-finite entries
+	template <numeric T> [[nodiscard]] std::optional<least_squares_solution<T>> least_squares(
+		const mtx::matrix<T>& a,
+		const mtx::column_vector<T>& b,
+		const least_squares_options<T>& options = {}
+	) noexcept;
+
+	// Fits every column of B against the same A with a single factorization
+	template <numeric T> [[nodiscard]] std::optional<least_squares_matrix_solution<T>> least_squares(
+		const mtx::matrix<T>& a,
+		const mtx::matrix<T>& b,
+		const least_squares_options<T>& options = {}
+	) noexcept;
+} // agla::lsq
+
+#endif // LEAST_SQUARES_HPP
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <limits>
+
+#include "mixed_precision.hpp"
+#include "../mtx/cholesky_decomposition.hpp"
+#include "../mtx/kernels.hpp"
+
+namespace agla::lsq {
+	[[nodiscard]] std::optional<mixed_precision_solution> solve_mixed_precision(
+		const mtx::matrix<double>& a,
+		const mtx::column_vector<double>& b,
+		const std::size_t max_iterations
+	) noexcept {
+		const auto m = a.rows_number();
+		const auto n = a.columns_number();
+
+		if (b.size() != m || m < n)
+			return std::nullopt;
+
+		mtx::square_matrix<float> gram(n);
+		std::vector<float> row_f(n);
+		std::vector<double> normal_rhs(n, 0);
+
+		for (std::size_t r = 0; r < m; ++r) {
+			const auto* const row = a.get_unchecked(r).data();
+			const auto br = b.get_unchecked(r);
+
+			std::copy(row, row + n, row_f.begin());
+			mtx::kernels::axpy(br, row, normal_rhs.data(), n);
+
+			for (std::size_t i = 0; i < n; ++i) {
+				const auto fi = row_f[i];
+				if (fi == 0) continue;
+
+				mtx::kernels::axpy(fi, row_f.data() + i, gram.get_unchecked(i).data() + i, n - i);
+			}
+		}
+
+		double gram_norm = 0;
+
+		for (std::size_t i = 0; i < n; ++i) {
+			auto* const gram_i = gram.get_unchecked(i).data();
+			double row_sum = 0;
+
+			for (std::size_t q = 0; q < i; ++q)
+				gram_i[q] = gram.get_unchecked(q).data()[i];
+
+			for (std::size_t q = 0; q < n; ++q)
+				row_sum += std::abs(gram_i[q]);
+
+			gram_norm = std::max(gram_norm, row_sum);
+		}
+
+		const auto factor = mtx::cholesky_decomposition<float>::from_square_matrix(gram);
+
+		if (!factor.has_value())
+			return std::nullopt;
+
+		const auto threshold = gram_norm * std::numeric_limits<double>::epsilon() * std::sqrt(static_cast<double>(n));
+
+		std::vector<double> x(n, 0);
+		std::vector<float> correction(n);
+		refinement_report report { false, 0, 0 };
+
+		for (;;) {
+			for (std::size_t i = 0; i < n; ++i)
+				correction[i] = static_cast<float>(normal_rhs[i]);
+
+			factor->solve_in_place(correction.data());
+
+			for (std::size_t i = 0; i < n; ++i)
+				x[i] += correction[i];
+
+			std::fill(normal_rhs.begin(), normal_rhs.end(), 0);
+
+			for (std::size_t r = 0; r < m; ++r) {
+				const auto* const row = a.get_unchecked(r).data();
+				const auto residual = b.get_unchecked(r) - mtx::kernels::dot(row, x.data(), n);
+				mtx::kernels::axpy(residual, row, normal_rhs.data(), n);
+			}
+
+			double x_norm = 0;
+			report.normal_residual_norm = 0;
+
+			for (std::size_t i = 0; i < n; ++i) {
+				x_norm = std::max(x_norm, std::abs(x[i]));
+				report.normal_residual_norm = std::max(report.normal_residual_norm, std::abs(normal_rhs[i]));
+			}
+
+			if (report.normal_residual_norm <= x_norm * threshold) {
+				report.converged = true;
+				break;
+			}
+
+			if (report.iterations == max_iterations)
+				break;
+
+			++report.iterations;
+		}
+
+		mtx::column_vector<double> result(n);
+
+		for (std::size_t i = 0; i < n; ++i)
+			result.get_unchecked(i) = x[i];
+
+		return std::make_optional(mixed_precision_solution { std::move(result), report });
+	}
+} // agla::lsq
@@ -0,0 +1,28 @@
+#ifndef MIXED_PRECISION_HPP
+#define MIXED_PRECISION_HPP
+
+#include "../mtx/column_vector.hpp"
+
+namespace agla::lsq {
+	struct refinement_report {
+		bool converged;
+		std::size_t iterations;
+		double normal_residual_norm;
+	};
+
+	struct mixed_precision_solution {
+		mtx::column_vector<double> x;
+		refinement_report refinement;
+	};
+
+	// Gram accumulation and Cholesky run in float, residuals and corrections in double.
+	// Returns nullopt when b does not match A, A has more columns than rows or A^T*A is not
+	// positive definite in single precision.
+	[[nodiscard]] std::optional<mixed_precision_solution> solve_mixed_precision(
+		const mtx::matrix<double>& a,
+		const mtx::column_vector<double>& b,
+		std::size_t max_iterations = 30
+	) noexcept;
+} // agla::lsq
+
+#endif // MIXED_PRECISION_HPP
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "predator_prey_fit.hpp"
+#include "../mtx/cholesky_decomposition.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::lsq {
+	namespace {
+		constexpr std::size_t parameters_number = 6;
+
+		// Samples per partial sum; fixed so the summation order never depends on the pool size
+		constexpr std::size_t chunk = 2048;
+
+		template <numeric T> struct partial_sums {
+			T jtj[parameters_number][parameters_number];
+			T jtr[parameters_number];
+			T cost;
+		};
+
+		// Constants shared by every sample for one parameter vector
+		template <numeric T> struct derived {
+			T omega;
+			T r;
+			T k_sin;
+			T v_sin;
+			T k_offset;
+			T v_offset;
+
+			explicit derived(const predator_prey_parameters<T>& p) noexcept
+				: omega(std::sqrt(p.a1 * p.a2)),
+				  r(std::sqrt(p.a1 / p.a2)),
+				  k_sin(p.v0 * r * p.b2 / p.b1),
+				  v_sin(-p.k0 * p.b1 / (p.b2 * r)),
+				  k_offset(p.a1 / p.b1),
+				  v_offset(p.a2 / p.b2) {}
+		};
+
+		template <numeric T> [[nodiscard]] bool valid(const predator_prey_parameters<T>& p) noexcept {
+			return p.a1 > 0 && p.a2 > 0 && p.b1 != 0 && p.b2 != 0 && std::isfinite(p.a1 * p.a2 * p.b1 * p.b2 * p.v0 * p.k0);
+		}
+
+		template <numeric T> [[nodiscard]] T* at(predator_prey_parameters<T>& p, const std::size_t index) noexcept {
+			T* const fields[parameters_number] = { &p.a1, &p.b1, &p.a2, &p.b2, &p.v0, &p.k0 };
+			return fields[index];
+		}
+
+		template <numeric T> [[nodiscard]] T chunked_cost(
+			const predator_prey_series<T>& data,
+			const predator_prey_parameters<T>& p,
+			std::vector<partial_sums<T>>& partials
+		) noexcept {
+			const derived<T> d(p);
+
+			par::thread_pool::instance().parallel_for(0, partials.size(), 1, [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t c = from; c < to; ++c) {
+					const auto end = std::min(data.count, (c + 1) * chunk);
+					T cost = 0;
+
+					for (std::size_t i = c * chunk; i < end; ++i) {
+						const auto angle = d.omega * data.times[i];
+						const auto sin = std::sin(angle);
+						const auto cos = std::cos(angle);
+
+						const auto residual_k = d.k_sin * sin + p.k0 * cos + d.k_offset - data.K[i];
+						const auto residual_v = d.v_sin * sin + p.v0 * cos + d.v_offset - data.V[i];
+						cost += residual_k * residual_k + residual_v * residual_v;
+					}
+
+					partials[c].cost = cost;
+				}
+			});
+
+			T cost = 0;
+
+			for (const auto& partial : partials)
+				cost += partial.cost;
+
+			return cost / 2;
+		}
+
+		// Gauss-Newton system J^T * J and J^T * r, with J the 2N x 6 Jacobian of [K - K_obs; V - V_obs]
+		template <numeric T> [[nodiscard]] T accumulate_normal_equations(
+			const predator_prey_series<T>& data,
+			const predator_prey_parameters<T>& p,
+			std::vector<partial_sums<T>>& partials,
+			partial_sums<T>& total
+		) noexcept {
+			const derived<T> d(p);
+
+			par::thread_pool::instance().parallel_for(0, partials.size(), 1, [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t c = from; c < to; ++c) {
+					auto& partial = partials[c];
+					partial = {};
+
+					const auto end = std::min(data.count, (c + 1) * chunk);
+
+					for (std::size_t i = c * chunk; i < end; ++i) {
+						const auto t = data.times[i];
+						const auto angle = d.omega * t;
+						const auto sin = std::sin(angle);
+						const auto cos = std::cos(angle);
+
+						const auto residual_k = d.k_sin * sin + p.k0 * cos + d.k_offset - data.K[i];
+						const auto residual_v = d.v_sin * sin + p.v0 * cos + d.v_offset - data.V[i];
+
+						// omega = sqrt(a1 * a2) and r = sqrt(a1 / a2) carry the a1, a2 dependence
+						const auto dk_domega = t * (d.k_sin * cos - p.k0 * sin);
+						const auto dv_domega = t * (d.v_sin * cos - p.v0 * sin);
+						const auto half_a1 = 1 / (2 * p.a1);
+						const auto half_a2 = 1 / (2 * p.a2);
+
+						const T grad_k[parameters_number] = {
+							(d.k_sin * sin + d.omega * dk_domega) * half_a1 + 1 / p.b1,
+							-(d.k_sin * sin + p.a1 / p.b1) / p.b1,
+							(d.omega * dk_domega - d.k_sin * sin) * half_a2,
+							d.k_sin * sin / p.b2,
+							d.r * p.b2 / p.b1 * sin,
+							cos
+						};
+
+						const T grad_v[parameters_number] = {
+							(d.omega * dv_domega - d.v_sin * sin) * half_a1,
+							d.v_sin * sin / p.b1,
+							(d.v_sin * sin + d.omega * dv_domega) * half_a2 + 1 / p.b2,
+							-(d.v_sin * sin + p.a2 / p.b2) / p.b2,
+							cos,
+							-p.b1 / (p.b2 * d.r) * sin
+						};
+
+						for (std::size_t j = 0; j < parameters_number; ++j) {
+							for (std::size_t q = j; q < parameters_number; ++q)
+								partial.jtj[j][q] += grad_k[j] * grad_k[q] + grad_v[j] * grad_v[q];
+
+							partial.jtr[j] += residual_k * grad_k[j] + residual_v * grad_v[j];
+						}
+
+						partial.cost += residual_k * residual_k + residual_v * residual_v;
+					}
+				}
+			});
+
+			total = {};
+
+			for (const auto& partial : partials) {
+				for (std::size_t j = 0; j < parameters_number; ++j) {
+					for (std::size_t q = j; q < parameters_number; ++q)
+						total.jtj[j][q] += partial.jtj[j][q];
+
+					total.jtr[j] += partial.jtr[j];
+				}
+
+				total.cost += partial.cost;
+			}
+
+			for (std::size_t j = 0; j < parameters_number; ++j)
+				for (std::size_t q = 0; q < j; ++q)
+					total.jtj[j][q] = total.jtj[q][j];
+
+			return total.cost / 2;
+		}
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<predator_prey_fit<T>> fit_predator_prey(
+		const predator_prey_series<T>& data,
+		const predator_prey_parameters<T>& initial,
+		const levenberg_marquardt_options<T>& options
+	) noexcept {
+		if (data.count == 0 || !valid(initial))
+			return std::nullopt;
+
+		// Workspaces live for the whole fit; iterations only overwrite them
+		std::vector<partial_sums<T>> partials((data.count + chunk - 1) / chunk);
+		partial_sums<T> system {};
+		mtx::square_matrix<T> damped(parameters_number);
+		T step[parameters_number];
+
+		auto current = initial;
+		auto cost = accumulate_normal_equations(data, current, partials, system);
+		auto damping = options.initial_damping;
+		T growth = 2;
+
+		predator_prey_fit<T> result { current, cost, 0, false };
+
+		for (; result.iterations < options.max_iterations; ++result.iterations) {
+			T gradient_norm = 0;
+
+			for (std::size_t j = 0; j < parameters_number; ++j)
+				gradient_norm = std::max(gradient_norm, std::abs(system.jtr[j]));
+
+			if (gradient_norm <= options.gradient_tolerance) {
+				result.converged = true;
+				break;
+			}
+
+			// Marquardt scaling: damp each parameter relative to its own curvature
+			for (std::size_t j = 0; j < parameters_number; ++j) {
+				auto* const row = damped.get_unchecked(j).data();
+				std::copy(system.jtj[j], system.jtj[j] + parameters_number, row);
+				row[j] += damping * std::max(system.jtj[j][j], std::numeric_limits<T>::min());
+				step[j] = -system.jtr[j];
+			}
+
+			const auto factor = mtx::cholesky_decomposition<T>::from_square_matrix(damped);
+
+			if (!factor.has_value()) {
+				damping *= growth;
+				growth *= 2;
+				continue;
+			}
+
+			factor->solve_in_place(step);
+
+			auto trial = current;
+			T step_norm = 0;
+			T parameters_norm = 0;
+
+			for (std::size_t j = 0; j < parameters_number; ++j) {
+				parameters_norm = std::max(parameters_norm, std::abs(*at(current, j)));
+				step_norm = std::max(step_norm, std::abs(step[j]));
+				*at(trial, j) += step[j];
+			}
+
+			if (step_norm <= options.step_tolerance * (parameters_norm + options.step_tolerance)) {
+				result.converged = true;
+				break;
+			}
+
+			// Reduction predicted by the quadratic model: -g^T * s - s^T * J^T * J * s / 2
+			T predicted = 0;
+
+			for (std::size_t j = 0; j < parameters_number; ++j) {
+				T curvature = 0;
+
+				for (std::size_t q = 0; q < parameters_number; ++q)
+					curvature += system.jtj[j][q] * step[q];
+
+				predicted -= step[j] * (system.jtr[j] + curvature / 2);
+			}
+
+			const auto trial_cost = valid(trial) ? chunked_cost(data, trial, partials) : std::numeric_limits<T>::infinity();
+			const auto gain = predicted > 0 ? (cost - trial_cost) / predicted : T(-1);
+
+			if (gain > 0 && std::isfinite(trial_cost)) {
+				current = trial;
+				cost = accumulate_normal_equations(data, current, partials, system);
+
+				const auto shrink = 2 * gain - 1;
+				damping *= std::max(T(1) / 3, 1 - shrink * shrink * shrink);
+				growth = 2;
+			} else {
+				damping *= growth;
+				growth *= 2;
+			}
+		}
+
+		result.parameters = current;
+		result.cost = cost;
+		return std::make_optional(result);
+	}
+
+	template std::optional<predator_prey_fit<double>> fit_predator_prey(
+		const predator_prey_series<double>& data,
+		const predator_prey_parameters<double>& initial,
+		const levenberg_marquardt_options<double>& options
+	) noexcept;
+
+	template std::optional<predator_prey_fit<float>> fit_predator_prey(
+		const predator_prey_series<float>& data,
+		const predator_prey_parameters<float>& initial,
+		const levenberg_marquardt_options<float>& options
+	) noexcept;
+
+	template std::optional<predator_prey_fit<long double>> fit_predator_prey(
+		const predator_prey_series<long double>& data,
+		const predator_prey_parameters<long double>& initial,
+		const levenberg_marquardt_options<long double>& options
+	) noexcept;
+} // agla::lsq
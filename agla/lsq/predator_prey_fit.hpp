@@ -0,0 +1,56 @@
+#ifndef PREDATOR_PREY_FIT_HPP
+#define PREDATOR_PREY_FIT_HPP
+
+#include <cstddef>
+#include <optional>
+
+#include "../mtx/matrix.hpp"
+
+namespace agla::lsq {
+	template <numeric T> struct predator_prey_parameters {
+		T a1;
+		T b1;
+		T a2;
+		T b2;
+		T v0;
+		T k0;
+	};
+
+	// Observed K(t_i) and V(t_i); the arrays are borrowed and must hold count elements
+	template <numeric T> struct predator_prey_series {
+		const T* times;
+		const T* K;
+		const T* V;
+		std::size_t count;
+	};
+
+	template <numeric T> struct levenberg_marquardt_options {
+		std::size_t max_iterations = 200;
+		T initial_damping = T(1e-3);
+
+		// Stop once ||J^T * r||_inf or the relative step falls below these
+		T gradient_tolerance = T(1e-10);
+		T step_tolerance = T(1e-10);
+	};
+
+	template <numeric T> struct predator_prey_fit {
+		predator_prey_parameters<T> parameters;
+
+		// 0.5 * sum of squared residuals of K and V
+		T cost;
+		std::size_t iterations;
+		bool converged;
+	};
+
+	// Levenberg-Marquardt on the closed-form K(t) and V(t) with analytic derivatives in all six
+	// parameters. Samples are streamed into J^T * J and J^T * r over fixed chunks on the shared pool,
+	// so the Jacobian is never stored and results do not depend on the number of threads.
+	// Returns nullopt for an empty series or a start with a1 <= 0, a2 <= 0, b1 == 0 or b2 == 0
+	template <numeric T> [[nodiscard]] std::optional<predator_prey_fit<T>> fit_predator_prey(
+		const predator_prey_series<T>& data,
+		const predator_prey_parameters<T>& initial,
+		const levenberg_marquardt_options<T>& options = {}
+	) noexcept;
+} // agla::lsq
+
+#endif // PREDATOR_PREY_FIT_HPP
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "savitzky_golay.hpp"
+#include "../mtx/identity_matrix.hpp"
+#include "../mtx/kernels.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::lsq {
+	namespace {
+
+		// Outputs per block: small enough that a block of in and out stays in L1 across the
+		// window's axpy passes
+		constexpr std::size_t block_outputs = 1 << 11;
+
+		// out[j] = sum of weights[k] * in[j + k] over k in [0, length), for j in [0, count)
+		template <numeric T> void convolve(const T* const weights, const std::size_t length, const T* const in, T* const out, const std::size_t count) noexcept {
+			const auto blocks = (count + block_outputs - 1) / block_outputs;
+
+			par::thread_pool::instance().parallel_for(0, blocks, par::thread_pool::grain_for(block_outputs * length), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t b = from; b < to; ++b) {
+					const auto start = b * block_outputs;
+					const auto n = std::min(block_outputs, count - start);
+
+					std::fill_n(out + start, n, T(0));
+
+					for (std::size_t k = 0; k < length; ++k)
+						mtx::kernels::axpy(weights[k], in + start + k, out + start, n);
+				}
+			});
+		}
+
+		[[nodiscard]] std::vector<long double> compute_weights(const std::size_t window, const std::size_t degree, const std::size_t derivative) noexcept {
+			const auto half = window / 2;
+			const auto unit = half > 0 ? static_cast<long double>(half) : 1.0L;
+
+			// Positions mapped onto [-1, 1] keep the monomial design well conditioned
+			std::vector<long double> t(window);
+
+			for (std::size_t j = 0; j < window; ++j)
+				t[j] = (static_cast<long double>(j) - static_cast<long double>(half)) / unit;
+
+			least_squares_options<long double> options;
+			options.force = solver::qr;
+
+			const auto factorization = least_squares_factorization<long double>::from_matrix(design_matrix(t, degree, basis::monomial), options);
+
+			if (!factorization.has_value())
+				return {};
+
+			// Row k of the pseudo-inverse maps the window onto coefficient k
+			const auto pseudo_inverse = factorization->solve(mtx::identity_matrix<long double>(window));
+
+			if (!pseudo_inverse.has_value())
+				return {};
+
+			std::vector<long double> weights(window * window, 0.0L);
+			const auto chain = std::pow(unit, -static_cast<long double>(derivative));
+
+			for (std::size_t p = 0; p < window; ++p) {
+				for (std::size_t k = derivative; k <= degree; ++k) {
+
+					// d^derivative / dt^derivative of t^k at t_p
+					auto factor = chain * std::pow(t[p], static_cast<long double>(k - derivative));
+
+					for (auto m = k - derivative + 1; m <= k; ++m)
+						factor *= static_cast<long double>(m);
+
+					const auto* const coefficient_row = pseudo_inverse->get_unchecked(k).data();
+
+					for (std::size_t j = 0; j < window; ++j)
+						weights[p * window + j] += factor * coefficient_row[j];
+				}
+			}
+
+			return weights;
+		}
+	}
+
+	// ########################## Weights ##########################
+
+	template <numeric T> [[nodiscard]] std::shared_ptr<const std::vector<T>> savitzky_golay_weights(
+		const std::size_t window,
+		const std::size_t degree,
+		const std::size_t derivative
+	) noexcept {
+		if (window % 2 == 0 || degree >= window || derivative > degree)
+			return nullptr;
+
+		static std::mutex mutex;
+		static std::map<std::tuple<std::size_t, std::size_t, std::size_t>, std::shared_ptr<const std::vector<T>>> cache;
+
+		const auto key = std::make_tuple(window, degree, derivative);
+
+		{
+			const std::lock_guard lock(mutex);
+
+			if (const auto it = cache.find(key); it != cache.end())
+				return it->second;
+		}
+
+		// Built outside the lock; a racing thread computes the same weights
+		const auto exact = compute_weights(window, degree, derivative);
+
+		if (exact.empty())
+			return nullptr;
+
+		auto weights = std::make_shared<const std::vector<T>>(exact.begin(), exact.end());
+
+		const std::lock_guard lock(mutex);
+		return cache.emplace(key, std::move(weights)).first->second;
+	}
+
+	// ########################## Filter ##########################
+
+	// ----------------------- Constructors -----------------------
+
+	template <numeric T> savitzky_golay<T>::savitzky_golay(const std::size_t length, const edge_mode edges, std::vector<T>&& weights) noexcept :
+		length(length),
+		edges(edges),
+		weights(std::move(weights)) {}
+
+	template <numeric T> [[nodiscard]] std::optional<savitzky_golay<T>> savitzky_golay<T>::create(
+		const std::size_t window,
+		const std::size_t degree,
+		const std::size_t derivative,
+		const T spacing,
+		const edge_mode edges
+	) noexcept {
+		const auto cached = savitzky_golay_weights<T>(window, degree, derivative);
+
+		if (cached == nullptr || !(spacing > 0))
+			return std::nullopt;
+
+		auto weights = *cached;
+		const auto scale = std::pow(spacing, -static_cast<T>(derivative));
+
+		for (auto& w : weights)
+			w *= scale;
+
+		return std::make_optional(savitzky_golay(window, edges, std::move(weights)));
+	}
+
+	// ----------------------- Operations -----------------------
+
+	template <numeric T> [[nodiscard]] T savitzky_golay<T>::edge_value(const T* const in, const std::size_t size, const std::size_t index) const noexcept {
+		const auto half = length / 2;
+		T result = 0;
+
+		if (edges == edge_mode::polynomial) {
+			const auto leading = index < half;
+			const auto row = leading ? index : index + length - size;
+			const auto* const data = leading ? in : in + size - length;
+			const auto* const w = weights.data() + row * length;
+
+			for (std::size_t k = 0; k < length; ++k)
+				result += w[k] * data[k];
+
+			return result;
+		}
+
+		const auto* const w = coefficients();
+		const auto last = static_cast<std::ptrdiff_t>(size) - 1;
+
+		for (std::size_t k = 0; k < length; ++k) {
+			auto j = static_cast<std::ptrdiff_t>(index + k) - static_cast<std::ptrdiff_t>(half);
+
+			if (edges == edge_mode::mirror)
+				j = j < 0 ? -j : j > last ? 2 * last - j : j;
+
+			result += w[k] * in[std::clamp<std::ptrdiff_t>(j, 0, last)];
+		}
+
+		return result;
+	}
+
+	template <numeric T> [[nodiscard]] bool savitzky_golay<T>::apply(const T* const in, T* const out, const std::size_t size) const noexcept {
+		const auto half = length / 2;
+
+		if (edges == edge_mode::polynomial && size < length)
+			return false;
+
+		if (size < length) {
+			for (std::size_t i = 0; i < size; ++i)
+				out[i] = edge_value(in, size, i);
+
+			return true;
+		}
+
+		convolve(coefficients(), length, in, out + half, size - 2 * half);
+
+		for (std::size_t i = 0; i < half; ++i) {
+			out[i] = edge_value(in, size, i);
+			out[size - half + i] = edge_value(in, size, size - half + i);
+		}
+
+		return true;
+	}
+
+	// ########################## Stream ##########################
+
+	// ----------------------- Constructors -----------------------
+
+	template <numeric T> savitzky_golay_stream<T>::savitzky_golay_stream(const savitzky_golay<T>& filter) noexcept : filter(filter) {}
+
+	// ----------------------- Operations -----------------------
+
+	template <numeric T> [[nodiscard]] std::size_t savitzky_golay_stream<T>::process(const T* const in, const std::size_t size, T* const out) noexcept {
+		const auto length = filter.window();
+		const auto half = length / 2;
+
+		buffer.assign(pending.begin(), pending.end());
+		buffer.insert(buffer.end(), in, in + size);
+
+		if (buffer.size() < length) {
+			pending.swap(buffer);
+			return 0;
+		}
+
+		// Centres from the first one without an output up to the last with a full window
+		std::size_t written = 0;
+		auto first = length - half;
+
+		// The first full window also settles the leading edge
+		if (!started) {
+			for (; written < half; ++written)
+				out[written] = filter.edge_value(buffer.data(), buffer.size(), written);
+
+			first = half;
+			started = true;
+		}
+
+		const auto count = buffer.size() - half - first;
+
+		convolve(filter.coefficients(), length, buffer.data() + first - half, out + written, count);
+		written += count;
+
+		pending.assign(buffer.end() - static_cast<std::ptrdiff_t>(length), buffer.end());
+		return written;
+	}
+
+	template <numeric T> [[nodiscard]] std::size_t savitzky_golay_stream<T>::finish(T* const out) noexcept {
+		const auto length = filter.window();
+		const auto half = length / 2;
+		std::size_t written = 0;
+
+		if (!started) {
+			if (filter.apply(pending.data(), out, pending.size()))
+				written = pending.size();
+		} else {
+			for (; written < half; ++written)
+				out[written] = filter.edge_value(pending.data(), length, length - half + written);
+		}
+
+		pending.clear();
+		started = false;
+		return written;
+	}
+
+	template std::shared_ptr<const std::vector<double>> savitzky_golay_weights(std::size_t window, std::size_t degree, std::size_t derivative) noexcept;
+
+	template savitzky_golay<double>::savitzky_golay(std::size_t length, edge_mode edges, std::vector<double>&& weights) noexcept;
+	template std::optional<savitzky_golay<double>> savitzky_golay<double>::create(std::size_t window, std::size_t degree, std::size_t derivative, double spacing, edge_mode edges) noexcept;
+	template double savitzky_golay<double>::edge_value(const double* in, std::size_t size, std::size_t index) const noexcept;
+	template bool savitzky_golay<double>::apply(const double* in, double* out, std::size_t size) const noexcept;
+
+	template savitzky_golay_stream<double>::savitzky_golay_stream(const savitzky_golay<double>& filter) noexcept;
+	template std::size_t savitzky_golay_stream<double>::process(const double* in, std::size_t size, double* out) noexcept;
+	template std::size_t savitzky_golay_stream<double>::finish(double* out) noexcept;
+
+	template std::shared_ptr<const std::vector<float>> savitzky_golay_weights(std::size_t window, std::size_t degree, std::size_t derivative) noexcept;
+
+	template savitzky_golay<float>::savitzky_golay(std::size_t length, edge_mode edges, std::vector<float>&& weights) noexcept;
+	template std::optional<savitzky_golay<float>> savitzky_golay<float>::create(std::size_t window, std::size_t degree, std::size_t derivative, float spacing, edge_mode edges) noexcept;
+	template float savitzky_golay<float>::edge_value(const float* in, std::size_t size, std::size_t index) const noexcept;
+	template bool savitzky_golay<float>::apply(const float* in, float* out, std::size_t size) const noexcept;
+
+	template savitzky_golay_stream<float>::savitzky_golay_stream(const savitzky_golay<float>& filter) noexcept;
+	template std::size_t savitzky_golay_stream<float>::process(const float* in, std::size_t size, float* out) noexcept;
+	template std::size_t savitzky_golay_stream<float>::finish(float* out) noexcept;
+
+	template std::shared_ptr<const std::vector<long double>> savitzky_golay_weights(std::size_t window, std::size_t degree, std::size_t derivative) noexcept;
+
+	template savitzky_golay<long double>::savitzky_golay(std::size_t length, edge_mode edges, std::vector<long double>&& weights) noexcept;
+	template std::optional<savitzky_golay<long double>> savitzky_golay<long double>::create(std::size_t window, std::size_t degree, std::size_t derivative, long double spacing, edge_mode edges) noexcept;
+	template long double savitzky_golay<long double>::edge_value(const long double* in, std::size_t size, std::size_t index) const noexcept;
+	template bool savitzky_golay<long double>::apply(const long double* in, long double* out, std::size_t size) const noexcept;
+
+	template savitzky_golay_stream<long double>::savitzky_golay_stream(const savitzky_golay<long double>& filter) noexcept;
+	template std::size_t savitzky_golay_stream<long double>::process(const long double* in, std::size_t size, long double* out) noexcept;
+	template std::size_t savitzky_golay_stream<long double>::finish(long double* out) noexcept;
+} // agla::lsq
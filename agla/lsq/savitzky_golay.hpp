@@ -0,0 +1,112 @@
+#ifndef SAVITZKY_GOLAY_HPP
+#define SAVITZKY_GOLAY_HPP
+
+#include <memory>
+
+#include "least_squares.hpp"
+
+namespace agla::lsq {
+	enum class edge_mode : std::uint8_t {
+
+		// The fit of the first or last full window, evaluated off-centre
+		polynomial,
+
+		// Samples reflected about the end one
+		mirror,
+
+		// End sample repeated
+		nearest
+	};
+
+	// ########################## Weights ##########################
+
+	// Row p of the window x window matrix holds the weights giving the derivative-th derivative, at
+	// position p, of the degree polynomial fitted to the window, for unit sample spacing. Row
+	// window / 2 is the classical centred filter, the others serve the edges. Computed once per
+	// (window, degree, derivative) from the QR pseudo-inverse of the window's design matrix in
+	// long double and cached for the process; null for even windows or degree >= window
+	template <numeric T> [[nodiscard]] std::shared_ptr<const std::vector<T>> savitzky_golay_weights(
+		std::size_t window,
+		std::size_t degree,
+		std::size_t derivative = 0
+	) noexcept;
+
+	// ########################## Filter ##########################
+
+	template <numeric T> class savitzky_golay_stream;
+
+	// Local polynomial least squares over uniformly spaced samples as a convolution. The interior
+	// runs as vectorized axpy passes over blocks of outputs, in parallel for long signals; every
+	// output sums its terms in the same order, so results do not depend on the thread count
+	template <numeric T> class savitzky_golay {
+		std::size_t length;
+		edge_mode edges;
+
+		// Scaled by spacing^-derivative
+		std::vector<T> weights;
+
+		friend class savitzky_golay_stream<T>;
+
+		savitzky_golay(std::size_t length, edge_mode edges, std::vector<T>&& weights) noexcept;
+
+		[[nodiscard]] T edge_value(const T* in, std::size_t size, std::size_t index) const noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		// Nullopt for even windows, degree >= window or derivative > degree
+		[[nodiscard]] static std::optional<savitzky_golay> create(
+			std::size_t window,
+			std::size_t degree,
+			std::size_t derivative = 0,
+			T spacing = 1,
+			edge_mode edges = edge_mode::polynomial
+		) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t window() const noexcept { return length; }
+		[[nodiscard]] inline edge_mode edge() const noexcept { return edges; }
+
+		// The window weights of the centred filter
+		[[nodiscard]] inline const T* coefficients() const noexcept { return weights.data() + length / 2 * length; }
+
+		// ----------------------- Operations -----------------------
+
+		// out[i] for every in[i]; in and out must not overlap. False, writing nothing, when
+		// polynomial edges have fewer samples than the window
+		[[nodiscard]] bool apply(const T* in, T* out, std::size_t size) const noexcept;
+	};
+
+	// ########################## Stream ##########################
+
+	// The filter over a signal arriving in chunks: outputs lag the inputs by window / 2 samples
+	// and match apply() on the whole signal exactly
+	template <numeric T> class savitzky_golay_stream {
+		savitzky_golay<T> filter;
+
+		// The last window samples, or all of them before the first output
+		std::vector<T> pending;
+		std::vector<T> buffer;
+		bool started = false;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		explicit savitzky_golay_stream(const savitzky_golay<T>& filter) noexcept;
+
+		// ----------------------- Operations -----------------------
+
+		// Writes the outputs that became available, at most size + window / 2 of them, and returns
+		// their count
+		[[nodiscard]] std::size_t process(const T* in, std::size_t size, T* out) noexcept;
+
+		// Writes the remaining outputs, at most window of them, and starts a new signal. Writes
+		// nothing when polynomial edges saw fewer samples than the window
+		[[nodiscard]] std::size_t finish(T* out) noexcept;
+	};
+} // agla::lsq
+
+#endif // SAVITZKY_GOLAY_HPP
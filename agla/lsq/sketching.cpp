@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <unordered_set>
+
+#include "sketching.hpp"
+#include "../mtx/blas.hpp"
+#include "../mtx/kernels.hpp"
+#include "../mtx/qr_decomposition.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::lsq {
+	namespace {
+
+		// splitmix64 finalizer
+		[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t z) noexcept {
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		// Draw j for row i, independent of the order rows are visited in
+		[[nodiscard]] constexpr std::uint64_t draw(const std::uint64_t seed, const std::uint64_t i, const std::uint64_t j) noexcept {
+			return mix(seed ^ mix(i * 0x9E3779B97F4A7C15ull + j));
+		}
+
+		[[nodiscard]] std::size_t sketch_rows(const sketch_kind kind, const std::size_t requested, const std::size_t m, const std::size_t n) noexcept {
+			if (requested > 0)
+				return std::min(requested, m);
+
+			const auto log_n = static_cast<std::size_t>(std::bit_width(n));
+			const auto rows = kind == sketch_kind::count_sketch ? 2 * n * n : std::max(4 * n, 2 * n * log_n);
+
+			return std::min(std::max(rows, n), m);
+		}
+
+		// ----------------------- Sparse embeddings -----------------------
+
+		template <numeric T> void sparse_sketch(
+			const mtx::matrix<T>& a,
+			const mtx::column_vector<T>& b,
+			const std::size_t rows,
+			const std::size_t nonzeros,
+			const std::uint64_t seed,
+			mtx::matrix<T>& result
+		) noexcept {
+			constexpr std::size_t min_block = 1 << 12;
+			constexpr std::size_t max_blocks = 64;
+			constexpr std::size_t max_partial_elements = 1 << 22;
+
+			const auto m = a.rows_number();
+			const auto n = a.columns_number();
+			const auto width = n + 1;
+			const auto scale = 1 / std::sqrt(static_cast<T>(nonzeros));
+
+			// The block count depends on the problem only, and partials are summed in block order
+			const auto blocks = std::max<std::size_t>(std::min({ max_blocks, (m + min_block - 1) / min_block, max_partial_elements / (rows * width) }), 1);
+			std::vector<std::vector<T>> partials(blocks);
+
+			par::thread_pool::instance().parallel_for(0, blocks, 1, [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t block = from; block < to; ++block) {
+					auto& partial = partials[block];
+					partial.assign(rows * width, T(0));
+
+					for (std::size_t i = block * m / blocks; i < (block + 1) * m / blocks; ++i) {
+						const auto* const row = a.get_unchecked(i).data();
+
+						for (std::size_t j = 0; j < nonzeros; ++j) {
+							const auto bits = draw(seed, i, j);
+							const auto target = partial.data() + (bits >> 1) % rows * width;
+							const auto sign = bits & 1 ? -scale : scale;
+
+							mtx::kernels::axpy(sign, row, target, n);
+							target[n] += sign * b.get_unchecked(i);
+						}
+					}
+				}
+			});
+
+			for (std::size_t r = 0; r < rows; ++r) {
+				auto* const out = result.get_unchecked(r).data();
+
+				for (const auto& partial : partials)
+					for (std::size_t q = 0; q < width; ++q)
+						out[q] += partial[r * width + q];
+			}
+		}
+
+		// ----------------------- SRHT -----------------------
+
+		template <numeric T> void hadamard_in_place(T* const x, const std::size_t size) noexcept {
+			for (std::size_t half = 1; half < size; half *= 2) {
+				for (std::size_t i = 0; i < size; i += 2 * half) {
+					for (std::size_t j = i; j < i + half; ++j) {
+						const auto u = x[j];
+						const auto v = x[j + half];
+						x[j] = u + v;
+						x[j + half] = u - v;
+					}
+				}
+			}
+		}
+
+		template <numeric T> void srht_sketch(
+			const mtx::matrix<T>& a,
+			const mtx::column_vector<T>& b,
+			const std::size_t rows,
+			const std::uint64_t seed,
+			mtx::matrix<T>& result
+		) noexcept {
+			const auto m = a.rows_number();
+			const auto n = a.columns_number();
+			const auto padded = std::bit_ceil(m);
+
+			// Floyd's sampling of distinct output rows, sorted for locality
+			std::unordered_set<std::size_t> picked;
+			std::vector<std::size_t> sample;
+			sample.reserve(rows);
+
+			for (auto j = padded - rows; j < padded; ++j) {
+				const auto t = static_cast<std::size_t>(draw(seed, j, 1) % (j + 1));
+				const auto chosen = picked.insert(t).second ? t : j;
+
+				if (chosen == j)
+					picked.insert(j);
+
+				sample.push_back(chosen);
+			}
+
+			std::sort(sample.begin(), sample.end());
+
+			// S = P * H * D / sqrt(rows) with the unnormalized +-1 Hadamard matrix H
+			const auto scale = 1 / std::sqrt(static_cast<T>(rows));
+
+			par::thread_pool::instance().parallel_for(0, n + 1, 1, [&](const std::size_t from, const std::size_t to) {
+				std::vector<T> column(padded);
+
+				for (std::size_t q = from; q < to; ++q) {
+					for (std::size_t i = 0; i < m; ++i) {
+						const auto value = q < n ? a.get_unchecked(i).get_unchecked(q) : b.get_unchecked(i);
+						column[i] = draw(seed, i, 0) & 1 ? -value : value;
+					}
+
+					std::fill(column.begin() + m, column.end(), T(0));
+					hadamard_in_place(column.data(), padded);
+
+					for (std::size_t r = 0; r < rows; ++r)
+						result.get_unchecked(r).get_unchecked(q) = column[sample[r]] * scale;
+				}
+			});
+		}
+	}
+
+	[[nodiscard]] const char* name(const sketch_kind kind) noexcept {
+		switch (kind) {
+			case sketch_kind::count_sketch: return "CountSketch";
+			case sketch_kind::sparse_sign: return "sparse sign";
+			case sketch_kind::srht: return "SRHT";
+		}
+
+		return "unknown";
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<mtx::matrix<T>> sketch(
+		const mtx::matrix<T>& a,
+		const mtx::column_vector<T>& b,
+		const sketch_options<T>& options
+	) noexcept {
+		const auto m = a.rows_number();
+		const auto n = a.columns_number();
+
+		// Either would leave S without rows
+		if (b.size() != m || m == 0 || n == 0)
+			return std::nullopt;
+
+		const auto rows = sketch_rows(options.kind, options.rows, m, n);
+		mtx::matrix<T> result(rows, n + 1, a.get_allocator());
+
+		switch (options.kind) {
+			case sketch_kind::count_sketch:
+				sparse_sketch(a, b, rows, 1, options.seed, result);
+				break;
+			case sketch_kind::sparse_sign:
+				sparse_sketch(a, b, rows, std::clamp<std::size_t>(options.nonzeros, 1, rows), options.seed, result);
+				break;
+			case sketch_kind::srht:
+				srht_sketch(a, b, rows, options.seed, result);
+				break;
+		}
+
+		return std::make_optional(std::move(result));
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<sketch_solution<T>> sketched_least_squares(
+		const mtx::matrix<T>& a,
+		const mtx::column_vector<T>& b,
+		const sketch_options<T>& options
+	) noexcept {
+		const auto m = a.rows_number();
+		const auto n = a.columns_number();
+
+		if (b.size() != m || m < n || n == 0)
+			return std::nullopt;
+
+		// ----------------------- Sketch and solve -----------------------
+
+		const auto sketched = sketch(a, b, options);
+
+		if (!sketched.has_value())
+			return std::nullopt;
+
+		const auto rows = sketched->rows_number();
+
+		mtx::matrix<T> sa(rows, n);
+		std::vector<T> buf(rows);
+
+		for (std::size_t r = 0; r < rows; ++r) {
+			const auto* const row = sketched->get_unchecked(r).data();
+			std::copy_n(row, n, sa.get_unchecked(r).data());
+			buf[r] = row[n];
+		}
+
+		const auto qr = mtx::qr_decomposition<T>::from_matrix(sa);
+
+		if (!qr.has_value() || !std::isfinite(qr->condition_estimate()))
+			return std::nullopt;
+
+		qr->apply_transposed_q(buf.data());
+		qr->solve_upper_in_place(buf.data());
+
+		mtx::column_vector<T> x(n);
+
+		for (std::size_t i = 0; i < n; ++i)
+			x.get_unchecked(i) = buf[i];
+
+		// ----------------------- Sketch and precondition -----------------------
+
+		const auto op = linear_operator<T>::from_matrix(a);
+		std::size_t iterations = 0;
+		bool converged = true;
+
+		if (options.refine) {
+			const preconditioner<T> r_factor {
+				[&qr](T* const v) { qr->solve_upper_in_place(v); },
+				[&qr](T* const v) { qr->solve_upper_transposed_in_place(v); }
+			};
+
+			auto refined = cgls(op, b, r_factor, options.iterative, std::make_optional(x));
+
+			if (!refined.has_value())
+				return std::nullopt;
+
+			x = std::move(refined->x);
+			iterations = refined->iterations;
+			converged = refined->converged;
+		}
+
+		// ----------------------- Error estimates -----------------------
+
+		// x - x* = (A^T * A)^-1 * A^T * r ~ R^-1 * R^-T * A^T * r
+		std::vector<T> solution(n);
+		std::vector<T> residual(m);
+		std::vector<T> correction(n);
+
+		for (std::size_t i = 0; i < n; ++i)
+			solution[i] = x.get_unchecked(i);
+
+		op.apply(solution.data(), residual.data());
+
+		for (std::size_t i = 0; i < m; ++i)
+			residual[i] -= b.get_unchecked(i);
+
+		op.apply_transposed(residual.data(), correction.data());
+		qr->solve_upper_transposed_in_place(correction.data());
+		const auto excess = std::sqrt(mtx::kernels::sum_of_squares(correction.data(), n));
+		qr->solve_upper_in_place(correction.data());
+
+		return std::make_optional(sketch_solution<T> {
+			std::move(x),
+			rows,
+			iterations,
+			converged,
+			mtx::blas::nrm2(residual.data(), m),
+			excess,
+			std::sqrt(mtx::kernels::sum_of_squares(correction.data(), n))
+		});
+	}
+
+	template std::optional<mtx::matrix<double>> sketch(
+		const mtx::matrix<double>& a,
+		const mtx::column_vector<double>& b,
+		const sketch_options<double>& options
+	) noexcept;
+
+	template std::optional<mtx::matrix<float>> sketch(
+		const mtx::matrix<float>& a,
+		const mtx::column_vector<float>& b,
+		const sketch_options<float>& options
+	) noexcept;
+
+	template std::optional<mtx::matrix<long double>> sketch(
+		const mtx::matrix<long double>& a,
+		const mtx::column_vector<long double>& b,
+		const sketch_options<long double>& options
+	) noexcept;
+
+	template std::optional<sketch_solution<double>> sketched_least_squares(
+		const mtx::matrix<double>& a,
+		const mtx::column_vector<double>& b,
+		const sketch_options<double>& options
+	) noexcept;
+
+	template std::optional<sketch_solution<float>> sketched_least_squares(
+		const mtx::matrix<float>& a,
+		const mtx::column_vector<float>& b,
+		const sketch_options<float>& options
+	) noexcept;
+
+	template std::optional<sketch_solution<long double>> sketched_least_squares(
+		const mtx::matrix<long double>& a,
+		const mtx::column_vector<long double>& b,
+		const sketch_options<long double>& options
+	) noexcept;
+} // agla::lsq
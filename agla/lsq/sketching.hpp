@@ -0,0 +1,78 @@
+#ifndef SKETCHING_HPP
+#define SKETCHING_HPP
+
+#include <cstdint>
+#include <limits>
+
+#include "cgls.hpp"
+
+namespace agla::lsq {
+	enum class sketch_kind : std::uint8_t {
+
+		// One +-1 per column of S; needs O(n^2) rows but touches each row of A once
+		count_sketch,
+
+		// nonzeros +-1/sqrt(nonzeros) per column of S; O(n log n) rows at a few times the cost
+		sparse_sign,
+
+		// Subsampled randomized Hadamard transform; O(n log n) rows, but transforms a padded
+		// copy of [A b] with O(m log m) work per column
+		srht
+	};
+
+	[[nodiscard]] const char* name(sketch_kind kind) noexcept;
+
+	template <numeric T> struct sketch_options {
+		sketch_kind kind = sketch_kind::sparse_sign;
+
+		// Rows of S; 0 picks 2 * n^2 for CountSketch and max(4 * n, 2 * n * log2(n)) otherwise,
+		// never more than the rows of A
+		std::size_t rows = 0;
+
+		// Nonzeros per column of S for the sparse sign embedding, drawn with replacement
+		std::size_t nonzeros = 8;
+
+		// S depends only on the seed, never on the thread count
+		std::uint64_t seed = 0x9E3779B97F4A7C15ull;
+
+		// Sketch-and-precondition: CGLS on A * R^-1, R from the QR of S * A, started from the
+		// sketch-and-solve point. Without it the sketched problem's solution is returned as is
+		bool refine = false;
+		cgls_options<T> iterative = { 100, 1000 * std::numeric_limits<T>::epsilon() };
+	};
+
+	template <numeric T> struct sketch_solution {
+		mtx::column_vector<T> x;
+		std::size_t sketch_rows;
+
+		// CGLS iterations; 0 and converged without refinement
+		std::size_t iterations;
+		bool converged;
+
+		// ||A * x - b||, exact
+		T residual_norm;
+
+		// A posteriori estimates of ||A * (x - x*)|| = sqrt(||r||^2 - ||r*||^2) and ||x - x*||
+		// through R^T * R ~ A^T * A; both are accurate up to the embedding distortion
+		T excess_residual_estimate;
+		T error_estimate;
+	};
+
+	// [S * A, S * b] in one pass over the rows of A, options.rows x (columns + 1). Returns nullopt
+	// when b does not match A or A has no rows or no columns
+	template <numeric T> [[nodiscard]] std::optional<mtx::matrix<T>> sketch(
+		const mtx::matrix<T>& a,
+		const mtx::column_vector<T>& b,
+		const sketch_options<T>& options = {}
+	) noexcept;
+
+	// argmin ||S * A * x - S * b||, optionally refined to argmin ||A * x - b||. Returns nullopt
+	// when b does not match A, A is wide or has no columns, or S * A is numerically rank deficient
+	template <numeric T> [[nodiscard]] std::optional<sketch_solution<T>> sketched_least_squares(
+		const mtx::matrix<T>& a,
+		const mtx::column_vector<T>& b,
+		const sketch_options<T>& options = {}
+	) noexcept;
+} // agla::lsq
+
+#endif // SKETCHING_HPP
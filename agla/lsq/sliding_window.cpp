@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+
+#include "sliding_window.hpp"
+#include "../mtx/kernels.hpp"
+
+namespace agla::lsq {
+
+	// ########################## Solution ##########################
+
+	template <numeric T> [[nodiscard]] T sliding_window_solution<T>::evaluate(const T x) const noexcept {
+		const auto columns = coefficients.size();
+		std::vector<T> row(columns);
+
+		design_row((x - center) / scale, columns - 1, kind, row.data());
+
+		T result = 0;
+
+		for (std::size_t i = 0; i < columns; ++i)
+			result += coefficients.get_unchecked(i) * row[i];
+
+		return result;
+	}
+
+	// ########################## Fit ##########################
+
+	// ----------------------- Constructors -----------------------
+
+	template <numeric T> sliding_window_fit<T>::sliding_window_fit(const std::size_t window, const sliding_window_options<T>& options) noexcept :
+		capacity(std::max<std::size_t>(window, 1)),
+		options(options),
+		columns(options.degree + 1),
+		xs(capacity),
+		ys(capacity),
+		rhs(columns),
+		row(columns) {}
+
+	// ----------------------- Operations -----------------------
+
+	template <numeric T> void sliding_window_fit<T>::fill_row(const T x) noexcept {
+		design_row((x - center) / scale, options.degree, options.kind, row.data());
+	}
+
+	template <numeric T> void sliding_window_fit<T>::refactor() noexcept {
+		since_refactor = 0;
+		factor.reset();
+
+		if (count < columns)
+			return;
+
+		++refactors;
+
+		const auto [lowest, highest] = std::minmax_element(xs.begin(), xs.begin() + count);
+		center = (*lowest + *highest) / 2;
+		scale = (*highest - *lowest) / 2;
+
+		if (!(scale > 0))
+			scale = 1;
+
+		mtx::square_matrix<T> gram(columns);
+		std::fill(rhs.begin(), rhs.end(), T(0));
+		squares = 0;
+
+		for (std::size_t i = 0; i < count; ++i) {
+			fill_row(xs[i]);
+
+			for (std::size_t r = 0; r < columns; ++r)
+				mtx::kernels::axpy(row[r], row.data(), gram.get_unchecked(r).data(), columns);
+
+			mtx::kernels::axpy(ys[i], row.data(), rhs.data(), columns);
+			squares += ys[i] * ys[i];
+		}
+
+		factor = mtx::cholesky_decomposition<T>::from_square_matrix(std::move(gram));
+	}
+
+	template <numeric T> void sliding_window_fit<T>::push(const T x, const T y) noexcept {
+		const auto interval = options.refactor_interval > 0 ? options.refactor_interval : capacity;
+		const auto full = count == capacity;
+		const auto slot = (head + count) % capacity;
+		const auto old_x = xs[slot];
+		const auto old_y = ys[slot];
+
+		xs[slot] = x;
+		ys[slot] = y;
+
+		if (full)
+			head = (head + 1) % capacity;
+		else
+			++count;
+
+		if (!factor.has_value() || ++since_refactor >= interval) {
+			refactor();
+			return;
+		}
+
+		// The incoming row goes in before the outgoing one leaves, so the Gram matrix stays as
+		// far from singular as the data allows
+		fill_row(x);
+		mtx::kernels::axpy(y, row.data(), rhs.data(), columns);
+		squares += y * y;
+		factor->update_unchecked(row.data());
+
+		if (!full)
+			return;
+
+		fill_row(old_x);
+		mtx::kernels::axpy(-old_y, row.data(), rhs.data(), columns);
+		squares -= old_y * old_y;
+
+		if (!factor->downdate_unchecked(row.data()))
+			refactor();
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<sliding_window_solution<T>> sliding_window_fit<T>::solve() const noexcept {
+		if (!factor.has_value())
+			return std::nullopt;
+
+		auto buf = rhs;
+		factor->solve_in_place(buf.data());
+
+		mtx::column_vector<T> coefficients(columns);
+
+		for (std::size_t i = 0; i < columns; ++i)
+			coefficients.get_unchecked(i) = buf[i];
+
+		const auto explained = mtx::kernels::dot(buf.data(), rhs.data(), columns);
+
+		return std::make_optional(sliding_window_solution<T> {
+			std::move(coefficients),
+			center,
+			scale,
+			options.kind,
+			std::sqrt(std::max(squares - explained, T(0)))
+		});
+	}
+
+	template double sliding_window_solution<double>::evaluate(double x) const noexcept;
+
+	template sliding_window_fit<double>::sliding_window_fit(std::size_t window, const sliding_window_options<double>& options) noexcept;
+	template void sliding_window_fit<double>::fill_row(double x) noexcept;
+	template void sliding_window_fit<double>::refactor() noexcept;
+	template void sliding_window_fit<double>::push(double x, double y) noexcept;
+	template std::optional<sliding_window_solution<double>> sliding_window_fit<double>::solve() const noexcept;
+
+	template float sliding_window_solution<float>::evaluate(float x) const noexcept;
+
+	template sliding_window_fit<float>::sliding_window_fit(std::size_t window, const sliding_window_options<float>& options) noexcept;
+	template void sliding_window_fit<float>::fill_row(float x) noexcept;
+	template void sliding_window_fit<float>::refactor() noexcept;
+	template void sliding_window_fit<float>::push(float x, float y) noexcept;
+	template std::optional<sliding_window_solution<float>> sliding_window_fit<float>::solve() const noexcept;
+
+	template long double sliding_window_solution<long double>::evaluate(long double x) const noexcept;
+
+	template sliding_window_fit<long double>::sliding_window_fit(std::size_t window, const sliding_window_options<long double>& options) noexcept;
+	template void sliding_window_fit<long double>::fill_row(long double x) noexcept;
+	template void sliding_window_fit<long double>::refactor() noexcept;
+	template void sliding_window_fit<long double>::push(long double x, long double y) noexcept;
+	template std::optional<sliding_window_solution<long double>> sliding_window_fit<long double>::solve() const noexcept;
+} // agla::lsq
@@ -0,0 +1,83 @@
+#ifndef SLIDING_WINDOW_HPP
+#define SLIDING_WINDOW_HPP
+
+#include "least_squares.hpp"
+
+namespace agla::lsq {
+	template <numeric T> struct sliding_window_options {
+		std::size_t degree = 2;
+		basis kind = basis::monomial;
+
+		// Samples between refactorizations from the stored window, which discard the drift of
+		// the rank-1 updates and re-centre the abscissae; 0 means the window size
+		std::size_t refactor_interval = 0;
+	};
+
+	template <numeric T> struct sliding_window_solution {
+
+		// Coefficients in t = (x - center) / scale, which maps the window at the last
+		// refactorization onto [-1, 1]
+		mtx::column_vector<T> coefficients;
+		T center;
+		T scale;
+		basis kind;
+
+		// sqrt(y^T * y - c^T * A^T * y): free, but loses digits to cancellation on close fits
+		T residual_norm;
+
+		[[nodiscard]] T evaluate(T x) const noexcept;
+	};
+
+	// Least-squares polynomial of the last `window` samples. Each sample costs a rank-1 update of
+	// the Cholesky factor of the Gram matrix for the incoming row and a downdate for the outgoing
+	// one, O(columns^2) whatever the window size; the periodic refactorization adds
+	// O(window * columns^2 / refactor_interval) amortized
+	template <numeric T> class sliding_window_fit {
+		std::size_t capacity;
+		sliding_window_options<T> options;
+		std::size_t columns;
+
+		// Ring buffer of samples, oldest at head once full
+		std::vector<T> xs;
+		std::vector<T> ys;
+		std::size_t head = 0;
+		std::size_t count = 0;
+
+		T center = 0;
+		T scale = 1;
+
+		// Factor of A^T * A, with A^T * y and y^T * y alongside
+		std::optional<mtx::cholesky_decomposition<T>> factor;
+		std::vector<T> rhs;
+		T squares = 0;
+
+		std::size_t since_refactor = 0;
+		std::size_t refactors = 0;
+		std::vector<T> row;
+
+		void fill_row(T x) noexcept;
+		void refactor() noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		explicit sliding_window_fit(std::size_t window, const sliding_window_options<T>& options = {}) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t size() const noexcept { return count; }
+		[[nodiscard]] inline std::size_t window() const noexcept { return capacity; }
+		[[nodiscard]] inline std::size_t refactorizations() const noexcept { return refactors; }
+
+		// ----------------------- Operations -----------------------
+
+		// Appends a sample, dropping the oldest one once the window is full
+		void push(T x, T y) noexcept;
+
+		// Nullopt until the window holds enough distinct abscissae for the degree
+		[[nodiscard]] std::optional<sliding_window_solution<T>> solve() const noexcept;
+	};
+} // agla::lsq
+
+#endif // SLIDING_WINDOW_HPP
@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <memory>
+
+#include "tsqr.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::lsq {
+	namespace {
+		struct file_closer {
+			void operator()(std::FILE* const file) const noexcept {
+				if (file != nullptr)
+					std::fclose(file);
+			}
+		};
+
+		struct text_reader {
+			std::unique_ptr<std::FILE, file_closer> file;
+			char* line = nullptr;
+			std::size_t capacity = 0;
+
+			explicit text_reader(std::FILE* const file) noexcept : file(file) {}
+			~text_reader() noexcept { std::free(line); }
+		};
+
+		[[nodiscard]] constexpr bool is_separator(const char c) noexcept {
+			return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r' || c == '\n';
+		}
+
+		// Exactly width numbers or false
+		template <numeric T> [[nodiscard]] bool parse_row(const char* it, const char* const end, const std::size_t width, T* const row) noexcept {
+			std::size_t count = 0;
+
+			for (;;) {
+				while (it != end && is_separator(*it))
+					++it;
+
+				if (it == end)
+					return count == width;
+
+				if (count == width)
+					return false;
+
+				const auto [next, error] = std::from_chars(it, end, row[count]);
+
+				if (error != std::errc() || (next != end && !is_separator(*next)))
+					return false;
+
+				it = next;
+				++count;
+			}
+		}
+
+		// R of the QR of rows that are already at least as many as columns
+		template <numeric T> [[nodiscard]] mtx::square_matrix<T> r_factor(const mtx::matrix<T>& stacked) noexcept {
+			return mtx::qr_decomposition<T>::from_matrix(stacked)->upper_triangular();
+		}
+
+		// Short leaves are padded with zero rows, which leave R unchanged
+		template <numeric T> [[nodiscard]] mtx::square_matrix<T> leaf_factor(const T* const rows, const std::size_t count, const std::size_t width) noexcept {
+			mtx::matrix<T> block(std::max(count, width), width);
+
+			for (std::size_t i = 0; i < count; ++i)
+				std::copy_n(rows + i * width, width, block.get_unchecked(i).data());
+
+			return r_factor(block);
+		}
+
+		template <numeric T> [[nodiscard]] mtx::square_matrix<T> merge_factors(const mtx::square_matrix<T>& top, const mtx::square_matrix<T>& bottom) noexcept {
+			const auto width = top.rows_number();
+			mtx::matrix<T> stacked(2 * width, width);
+
+			for (std::size_t i = 0; i < width; ++i) {
+				std::copy_n(top.get_unchecked(i).data(), width, stacked.get_unchecked(i).data());
+				std::copy_n(bottom.get_unchecked(i).data(), width, stacked.get_unchecked(width + i).data());
+			}
+
+			return r_factor(stacked);
+		}
+
+		// Binary-counter reduction: equal levels merge as soon as they meet, so the tree is
+		// balanced and at most log2(leaves) factors are alive
+		template <numeric T> class reduction_tree {
+			struct node {
+				std::size_t level;
+				mtx::square_matrix<T> r;
+			};
+
+			std::vector<node> stack;
+
+		 public:
+			void push(mtx::square_matrix<T>&& r) noexcept {
+				stack.push_back(node { 0, std::move(r) });
+
+				while (stack.size() >= 2 && stack[stack.size() - 1].level == stack[stack.size() - 2].level)
+					collapse();
+			}
+
+			[[nodiscard]] std::optional<mtx::square_matrix<T>> finish() noexcept {
+				if (stack.empty())
+					return std::nullopt;
+
+				while (stack.size() >= 2)
+					collapse();
+
+				return std::make_optional(std::move(stack.back().r));
+			}
+
+		 private:
+			void collapse() noexcept {
+				auto bottom = std::move(stack.back());
+				stack.pop_back();
+
+				auto& top = stack.back();
+				top.r = merge_factors(top.r, bottom.r);
+				top.level = std::max(top.level, bottom.level) + 1;
+			}
+		};
+	}
+
+	// ########################## Row Source ##########################
+
+	template <numeric T> [[nodiscard]] std::optional<row_source<T>> row_source<T>::binary_file(
+		const char* const path,
+		const std::size_t width,
+		const std::size_t first_row,
+		const std::size_t row_count
+	) noexcept {
+		std::shared_ptr<std::FILE> file(std::fopen(path, "rb"), file_closer {});
+
+		if (file == nullptr || width == 0 || ::fseeko(file.get(), static_cast<off_t>(first_row * width * sizeof(T)), SEEK_SET) != 0)
+			return std::nullopt;
+
+		const auto remaining = std::make_shared<std::size_t>(row_count);
+
+		return std::make_optional(row_source {
+			width,
+			[file, width, remaining](T* const rows, const std::size_t max_rows) {
+				const auto count = std::fread(rows, sizeof(T) * width, std::min(max_rows, *remaining), file.get());
+				*remaining -= count;
+				return count;
+			}
+		});
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<row_source<T>> row_source<T>::text_file(const char* const path, const std::size_t width) noexcept {
+		auto* const file = std::fopen(path, "r");
+
+		if (file == nullptr || width == 0) {
+			if (file != nullptr)
+				std::fclose(file);
+
+			return std::nullopt;
+		}
+
+		const auto reader = std::make_shared<text_reader>(file);
+
+		return std::make_optional(row_source {
+			width,
+			[reader, width](T* const rows, const std::size_t max_rows) {
+				std::size_t count = 0;
+
+				while (count < max_rows) {
+					const auto length = ::getline(&reader->line, &reader->capacity, reader->file.get());
+
+					if (length < 0)
+						break;
+
+					if (parse_row(reader->line, reader->line + length, width, rows + count * width))
+						++count;
+				}
+
+				return count;
+			}
+		});
+	}
+
+	template <numeric T> [[nodiscard]] row_source<T> row_source<T>::polynomial(row_source points, const std::size_t degree, const basis kind) noexcept {
+		const auto width = degree + 2;
+		const auto inner = std::make_shared<row_source>(std::move(points));
+		const auto buf = std::make_shared<std::vector<T>>();
+
+		return row_source {
+			width,
+			[inner, buf, degree, kind, width](T* const rows, const std::size_t max_rows) -> std::size_t {
+				if (inner->width != 2)
+					return 0;
+
+				buf->resize(2 * max_rows);
+				const auto count = inner->read(buf->data(), max_rows);
+
+				for (std::size_t i = 0; i < count; ++i) {
+					design_row((*buf)[2 * i], degree, kind, rows + i * width);
+					rows[i * width + width - 1] = (*buf)[2 * i + 1];
+				}
+
+				return count;
+			}
+		};
+	}
+
+	// ########################## TSQR ##########################
+
+	template <numeric T> [[nodiscard]] std::optional<tsqr_factor<T>> tsqr_factor<T>::from_source(
+		row_source<T>& source,
+		const tsqr_options<T>& options
+	) noexcept {
+		const auto width = source.width;
+
+		if (width < 2)
+			return std::nullopt;
+
+		const auto block_rows = std::max(options.block_rows, width);
+		const auto blocks = std::max<std::size_t>(options.blocks_per_read, 1);
+		const auto capacity = block_rows * blocks;
+
+		std::vector<T> buffers[2] = { std::vector<T>(capacity * width), std::vector<T>(capacity * width) };
+		std::vector<std::optional<mtx::square_matrix<T>>> leaves(blocks);
+		reduction_tree<T> tree;
+		std::size_t total = 0;
+
+		const auto read_into = [&source, capacity](std::vector<T>& buf) { return source.read(buf.data(), capacity); };
+		auto pending = std::async(std::launch::async, read_into, std::ref(buffers[0]));
+
+		for (std::size_t current = 0;; current ^= 1) {
+			const auto rows = pending.get();
+
+			if (rows == 0)
+				break;
+
+			// The reader fills the other buffer while this one is factorized
+			pending = std::async(std::launch::async, read_into, std::ref(buffers[current ^ 1]));
+
+			const auto* const data = buffers[current].data();
+			const auto count = (rows + block_rows - 1) / block_rows;
+
+			par::thread_pool::instance().parallel_for(0, count, 1, [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t k = from; k < to; ++k) {
+					const auto first = k * block_rows;
+					leaves[k] = leaf_factor(data + first * width, std::min(block_rows, rows - first), width);
+				}
+			});
+
+			for (std::size_t k = 0; k < count; ++k)
+				tree.push(std::move(*leaves[k]));
+
+			total += rows;
+		}
+
+		auto r = tree.finish();
+
+		if (!r.has_value())
+			return std::nullopt;
+
+		return std::make_optional(tsqr_factor { std::move(*r), total });
+	}
+
+	template <numeric T> [[nodiscard]] tsqr_factor<T> tsqr_factor<T>::merged_unchecked(const tsqr_factor& other) const noexcept {
+		return tsqr_factor { merge_factors(r, other.r), rows + other.rows };
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<tsqr_solution<T>> tsqr_factor<T>::solve(const T rank_tolerance) const noexcept {
+		const auto n = r.rows_number() - 1;
+
+		if (rows < n)
+			return std::nullopt;
+
+		// R = [R_A, Q^T * b; 0, +-||r||]
+		mtx::matrix<T> upper(n, n);
+		std::vector<T> y(n);
+
+		for (std::size_t i = 0; i < n; ++i) {
+			const auto* const row = r.get_unchecked(i).data();
+			std::copy_n(row, n, upper.get_unchecked(i).data());
+			y[i] = row[n];
+		}
+
+		const auto svd = mtx::singular_value_decomposition<T>::from_matrix(upper);
+		const auto tolerance = rank_tolerance > 0 ? rank_tolerance : static_cast<T>(n) * std::numeric_limits<T>::epsilon();
+
+		svd->solve_in_place(y.data(), tolerance);
+		mtx::column_vector<T> x(n);
+
+		for (std::size_t i = 0; i < n; ++i)
+			x.get_unchecked(i) = y[i];
+
+		return std::make_optional(tsqr_solution<T> {
+			std::move(x),
+			rows,
+			std::abs(r.get_unchecked(n).get_unchecked(n)),
+			svd->condition_number(),
+			svd->rank(tolerance)
+		});
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<tsqr_solution<T>> tsqr_least_squares(
+		row_source<T>& source,
+		const tsqr_options<T>& options
+	) noexcept {
+		const auto factor = tsqr_factor<T>::from_source(source, options);
+
+		if (!factor.has_value())
+			return std::nullopt;
+
+		return factor->solve(options.rank_tolerance);
+	}
+
+	template std::optional<row_source<double>> row_source<double>::binary_file(const char* path, std::size_t width, std::size_t first_row, std::size_t row_count) noexcept;
+	template std::optional<row_source<float>> row_source<float>::binary_file(const char* path, std::size_t width, std::size_t first_row, std::size_t row_count) noexcept;
+	template std::optional<row_source<long double>> row_source<long double>::binary_file(const char* path, std::size_t width, std::size_t first_row, std::size_t row_count) noexcept;
+
+	template std::optional<row_source<double>> row_source<double>::text_file(const char* path, std::size_t width) noexcept;
+	template std::optional<row_source<float>> row_source<float>::text_file(const char* path, std::size_t width) noexcept;
+	template std::optional<row_source<long double>> row_source<long double>::text_file(const char* path, std::size_t width) noexcept;
+
+	template row_source<double> row_source<double>::polynomial(row_source points, std::size_t degree, basis kind) noexcept;
+	template row_source<float> row_source<float>::polynomial(row_source points, std::size_t degree, basis kind) noexcept;
+	template row_source<long double> row_source<long double>::polynomial(row_source points, std::size_t degree, basis kind) noexcept;
+
+	template std::optional<tsqr_factor<double>> tsqr_factor<double>::from_source(row_source<double>& source, const tsqr_options<double>& options) noexcept;
+	template tsqr_factor<double> tsqr_factor<double>::merged_unchecked(const tsqr_factor& other) const noexcept;
+	template std::optional<tsqr_solution<double>> tsqr_factor<double>::solve(double rank_tolerance) const noexcept;
+
+	template std::optional<tsqr_factor<float>> tsqr_factor<float>::from_source(row_source<float>& source, const tsqr_options<float>& options) noexcept;
+	template tsqr_factor<float> tsqr_factor<float>::merged_unchecked(const tsqr_factor& other) const noexcept;
+	template std::optional<tsqr_solution<float>> tsqr_factor<float>::solve(float rank_tolerance) const noexcept;
+
+	template std::optional<tsqr_factor<long double>> tsqr_factor<long double>::from_source(row_source<long double>& source, const tsqr_options<long double>& options) noexcept;
+	template tsqr_factor<long double> tsqr_factor<long double>::merged_unchecked(const tsqr_factor& other) const noexcept;
+	template std::optional<tsqr_solution<long double>> tsqr_factor<long double>::solve(long double rank_tolerance) const noexcept;
+
+	template std::optional<tsqr_solution<double>> tsqr_least_squares(row_source<double>& source, const tsqr_options<double>& options) noexcept;
+	template std::optional<tsqr_solution<float>> tsqr_least_squares(row_source<float>& source, const tsqr_options<float>& options) noexcept;
+	template std::optional<tsqr_solution<long double>> tsqr_least_squares(row_source<long double>& source, const tsqr_options<long double>& options) noexcept;
+} // agla::lsq
@@ -0,0 +1,92 @@
+#ifndef TSQR_HPP
+#define TSQR_HPP
+
+#include <functional>
+
+#include "least_squares.hpp"
+
+namespace agla::lsq {
+
+	// ########################## Row Source ##########################
+
+	// Sequential reader of rows [a_i, b_i], width values each
+	template <numeric T> struct row_source {
+		std::size_t width;
+
+		// Fills up to max_rows rows; returns the number read, 0 at the end of the data
+		std::function<std::size_t(T* rows, std::size_t max_rows)> read;
+
+		// Raw host-order values of T, width per row; a trailing partial row is ignored. Reads
+		// at most row_count rows from first_row on. Returns nullopt when the file cannot be opened
+		[[nodiscard]] static std::optional<row_source> binary_file(
+			const char* path,
+			std::size_t width,
+			std::size_t first_row = 0,
+			std::size_t row_count = std::numeric_limits<std::size_t>::max()
+		) noexcept;
+
+		// One row per line, values separated by spaces, tabs, commas or semicolons. Lines that
+		// do not hold exactly width numbers (headers, comments) are skipped
+		[[nodiscard]] static std::optional<row_source> text_file(const char* path, std::size_t width) noexcept;
+
+		// Expands rows (x, y) of points into [p_0(x), ..., p_degree(x), y]
+		[[nodiscard]] static row_source polynomial(row_source points, std::size_t degree, basis kind = basis::monomial) noexcept;
+	};
+
+	// ########################## TSQR ##########################
+
+	template <numeric T> struct tsqr_options {
+
+		// Rows per leaf QR; leaves are merged pairwise in file order, so results do not depend
+		// on the thread count
+		std::size_t block_rows = 1 << 14;
+
+		// Leaves per read. Two buffers are alive, one filled by a reader thread while the
+		// leaves of the other are factorized in parallel, which bounds memory to about
+		// 2 * blocks_per_read * block_rows * width values
+		std::size_t blocks_per_read = 16;
+
+		// Singular values of R below rank_tolerance * sigma_max are dropped;
+		// 0 means columns * epsilon
+		T rank_tolerance = 0;
+	};
+
+	template <numeric T> struct tsqr_solution {
+		mtx::column_vector<T> x;
+		std::size_t rows;
+		T residual_norm;
+
+		// 2-norm kappa(A) and numerical rank from the SVD of R
+		T condition_number;
+		std::size_t rank;
+	};
+
+	// R of [A b] = Q * R without Q: the last column carries Q^T * b and the residual norm, so it
+	// summarizes its rows completely and the factors of disjoint row sets merge into the factor
+	// of their union
+	template <numeric T> struct tsqr_factor {
+		mtx::square_matrix<T> r;
+		std::size_t rows;
+
+		// ----------------------- Constructors -----------------------
+
+		// Streams the source once; nullopt for sources of width < 2 or without rows
+		[[nodiscard]] static std::optional<tsqr_factor> from_source(row_source<T>& source, const tsqr_options<T>& options = {}) noexcept;
+
+		// ----------------------- Operations -----------------------
+
+		// Factor of the rows of both, these first; widths must match
+		[[nodiscard]] tsqr_factor merged_unchecked(const tsqr_factor& other) const noexcept;
+
+		// Nullopt with fewer rows than columns of A
+		[[nodiscard]] std::optional<tsqr_solution<T>> solve(T rank_tolerance = 0) const noexcept;
+	};
+
+	// tsqr_factor<T>::from_source(source, options)->solve(options.rank_tolerance)
+	template <numeric T> [[nodiscard]] std::optional<tsqr_solution<T>> tsqr_least_squares(
+		row_source<T>& source,
+		const tsqr_options<T>& options = {}
+	) noexcept;
+} // agla::lsq
+
+#endif // TSQR_HPP
@@ -0,0 +1,43 @@
+#include <algorithm>
+
+#include "aligned_resource.hpp"
+
+namespace agla::mtx {
+	namespace {
+		[[nodiscard]] constexpr std::size_t padded(const std::size_t bytes) noexcept {
+			return (bytes + aligned_resource::line - 1) / aligned_resource::line * aligned_resource::line;
+		}
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	[[nodiscard]] aligned_resource* aligned_resource::instance() noexcept {
+		static aligned_resource resource;
+		return &resource;
+	}
+
+	// ----------------------- Resource -----------------------
+
+	// Blocks shorter than a line pass through untouched: padding them would multiply the
+	// footprint of narrow rows and column vectors for no gain
+
+	void* aligned_resource::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+		if (bytes < line)
+			return upstream->allocate(bytes, alignment);
+
+		return upstream->allocate(padded(bytes), std::max(alignment, line));
+	}
+
+	void aligned_resource::do_deallocate(void* const ptr, const std::size_t bytes, const std::size_t alignment) {
+		if (bytes < line) {
+			upstream->deallocate(ptr, bytes, alignment);
+			return;
+		}
+
+		upstream->deallocate(ptr, padded(bytes), std::max(alignment, line));
+	}
+
+	[[nodiscard]] bool aligned_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+} // agla::mtx
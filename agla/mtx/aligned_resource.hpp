@@ -0,0 +1,32 @@
+#ifndef ALIGNED_RESOURCE_HPP
+#define ALIGNED_RESOURCE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace agla::mtx {
+
+	// Hands out blocks of at least a cache line aligned and padded to whole lines, so the vector
+	// kernels start on full-width loads and buffers written by different threads never share a
+	// line; smaller blocks are forwarded as requested. Backs the Gram partials and the Strassen
+	// scratch; pass it explicitly for other wide buffers rather than as the process default
+	class aligned_resource : public std::pmr::memory_resource {
+		std::pmr::memory_resource* upstream;
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	 public:
+		static constexpr std::size_t line = 64;
+
+		// ----------------------- Constructors -----------------------
+
+		explicit aligned_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept : upstream(upstream) {}
+
+		// Process-wide instance over new/delete
+		[[nodiscard]] static aligned_resource* instance() noexcept;
+	};
+} // agla::mtx
+
+#endif // ALIGNED_RESOURCE_HPP
@@ -0,0 +1,46 @@
+#include <algorithm>
+
+#include "arena.hpp"
+
+namespace agla::mtx {
+
+	// ########################## Spill Counter ##########################
+
+	void* arena::spill_counter::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+		spilled += bytes;
+		return upstream->allocate(bytes, alignment);
+	}
+
+	void arena::spill_counter::do_deallocate(void* const ptr, const std::size_t bytes, const std::size_t alignment) {
+		upstream->deallocate(ptr, bytes, alignment);
+	}
+
+	[[nodiscard]] bool arena::spill_counter::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+
+	// ########################## Arena ##########################
+
+	// ----------------------- Constructors -----------------------
+
+	arena::arena(const std::size_t initial_capacity, std::pmr::memory_resource* const upstream) noexcept :
+		capacity(std::max<std::size_t>(initial_capacity, 1)),
+		storage(std::make_unique_for_overwrite<std::byte[]>(capacity)),
+		spill(upstream) {
+		buffer.emplace(storage.get(), capacity, &spill);
+	}
+
+	// ----------------------- Operations -----------------------
+
+	void arena::reset() noexcept {
+		buffer.reset();
+
+		if (spill.spilled > 0) {
+			capacity += spill.spilled;
+			storage = std::make_unique_for_overwrite<std::byte[]>(capacity);
+			spill.spilled = 0;
+		}
+
+		buffer.emplace(storage.get(), capacity, &spill);
+	}
+} // agla::mtx
@@ -0,0 +1,56 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace agla::mtx {
+
+	// Monotonic memory for matrix temporaries: allocation bumps a pointer, deallocation is a no-op
+	// and reset() hands the whole block back at once. Not thread-safe, so keep one arena per thread
+	class arena {
+
+		// Forwards to the upstream resource and remembers how much the arena spilled into it
+		class spill_counter : public std::pmr::memory_resource {
+			std::pmr::memory_resource* upstream;
+
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+			void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+			[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		 public:
+			std::size_t spilled = 0;
+
+			explicit spill_counter(std::pmr::memory_resource* upstream) noexcept : upstream(upstream) {}
+		};
+
+		std::size_t capacity;
+		std::unique_ptr<std::byte[]> storage;
+		spill_counter spill;
+		std::optional<std::pmr::monotonic_buffer_resource> buffer;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		explicit arena(std::size_t initial_capacity = 1 << 20, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::pmr::memory_resource* resource() noexcept { return &*buffer; }
+		[[nodiscard]] inline std::size_t reserved() const noexcept { return capacity; }
+
+		// ----------------------- Operations -----------------------
+
+		// Invalidates everything allocated from the arena. If the last request spilled past
+		// the reserved block, the block grows so that the next one fits without spilling
+		void reset() noexcept;
+	};
+} // agla::mtx
+
+#endif // ARENA_HPP
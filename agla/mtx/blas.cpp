@@ -0,0 +1,219 @@
+#include <array>
+#include <cmath>
+
+#include "blas.hpp"
+#include "kernels.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::mtx::blas {
+	namespace {
+
+		// Below this many chunks the pool costs more than it saves
+		constexpr std::size_t parallel_chunks = 16;
+
+		// chunk(from, to) for each chunk of [0, size), merged in chunk order whether or not the
+		// chunks ran in parallel
+		template <typename R, typename Chunk, typename Merge> [[nodiscard]] R reduce_chunks(const std::size_t size, R total, Chunk&& chunk, Merge&& merge) noexcept {
+			const auto chunks = (size + chunk_size - 1) / chunk_size;
+
+			if (chunks < parallel_chunks) {
+				for (std::size_t k = 0; k < chunks; ++k)
+					total = merge(total, chunk(k * chunk_size, std::min(size, (k + 1) * chunk_size)));
+
+				return total;
+			}
+
+			std::vector<R> partials(chunks);
+
+			par::thread_pool::instance().parallel_for(0, chunks, 1, [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t k = from; k < to; ++k)
+					partials[k] = chunk(k * chunk_size, std::min(size, (k + 1) * chunk_size));
+			});
+
+			for (const auto& partial : partials)
+				total = merge(total, partial);
+
+			return total;
+		}
+
+		template <numeric T> [[nodiscard]] kernels::double_word<T> add(const kernels::double_word<T> total, const kernels::double_word<T> part) noexcept {
+			const auto sum = kernels::two_sum(total.hi, part.hi);
+			return { sum.hi, total.lo + (part.lo + sum.lo) };
+		}
+
+		// Keeps NaN, so the norm of a vector holding one is NaN
+		template <numeric T> [[nodiscard]] T larger(const T a, const T b) noexcept {
+			return std::isnan(b) || b > a ? b : a;
+		}
+
+		template <typename Chunk> void for_chunks(const std::size_t size, Chunk&& chunk) noexcept {
+			if (size < parallel_chunks * chunk_size) {
+				chunk(0, size);
+				return;
+			}
+
+			par::thread_pool::instance().parallel_for(0, size, chunk_size, chunk);
+		}
+
+		template <numeric T> void gather(const column_vector<T>& x, const std::size_t from, const std::size_t to, T* const out) noexcept {
+			for (auto i = from; i < to; ++i)
+				out[i - from] = x.get_unchecked(i);
+		}
+
+		// sqrt of the sum of squares of the values load(from, to, buffer) points to, scaled by a
+		// power of two outside the range where the squares neither overflow nor underflow
+		template <numeric T, typename Load> [[nodiscard]] T scaled_norm(const std::size_t size, const T largest, Load&& load) noexcept {
+			if (size == 0 || !(largest > 0) || std::isinf(largest))
+				return largest;
+
+			const auto small = std::sqrt(std::numeric_limits<T>::min() / std::numeric_limits<T>::epsilon());
+			const auto big = std::sqrt(std::numeric_limits<T>::max() / kernels::split_factor<T> / static_cast<T>(size));
+			const auto exponent = largest < small || largest > big ? std::ilogb(largest) : 0;
+			const auto scale = std::ldexp(T(1), -exponent);
+
+			const auto squares = reduce_chunks(size, kernels::double_word<T> { 0, 0 }, [&](const std::size_t from, const std::size_t to) {
+				std::array<T, chunk_size> buffer;
+				const auto* const values = load(from, to, buffer.data());
+
+				if (exponent == 0)
+					return kernels::dot2(values, values, to - from);
+
+				for (auto i = from; i < to; ++i)
+					buffer[i - from] = values[i - from] * scale;
+
+				return kernels::dot2(buffer.data(), buffer.data(), to - from);
+			}, add<T>);
+
+			return std::ldexp(std::sqrt(squares.value()), exponent);
+		}
+	}
+
+	// ----------------------- Contiguous -----------------------
+
+	template <numeric T> [[nodiscard]] T dot(const T* const x, const T* const y, const std::size_t size) noexcept {
+		return reduce_chunks(size, kernels::double_word<T> { 0, 0 }, [x, y](const std::size_t from, const std::size_t to) {
+			return kernels::dot2(x + from, y + from, to - from);
+		}, add<T>).value();
+	}
+
+	template <numeric T> [[nodiscard]] T nrm2(const T* const x, const std::size_t size) noexcept {
+		const auto largest = reduce_chunks(size, T(0), [x](const std::size_t from, const std::size_t to) {
+			T result = 0;
+
+			for (auto i = from; i < to; ++i)
+				result = larger(result, std::abs(x[i]));
+
+			return result;
+		}, larger<T>);
+
+		return scaled_norm(size, largest, [x](const std::size_t from, std::size_t, T*) { return x + from; });
+	}
+
+	template <numeric T> void axpy(const T alpha, const T* const x, T* const y, const std::size_t size) noexcept {
+		for_chunks(size, [=](const std::size_t from, const std::size_t to) {
+			kernels::axpy(alpha, x + from, y + from, to - from);
+		});
+	}
+
+	template <numeric T> void scal(const T alpha, T* const x, const std::size_t size) noexcept {
+		for_chunks(size, [=](const std::size_t from, const std::size_t to) {
+			kernels::scal(alpha, x + from, to - from);
+		});
+	}
+
+	// ----------------------- Column vectors -----------------------
+
+	template <numeric T> [[nodiscard]] std::optional<T> dot(const column_vector<T>& x, const column_vector<T>& y) noexcept {
+		if (x.size() != y.size())
+			return std::nullopt;
+
+		return std::make_optional(dot_unchecked(x, y));
+	}
+
+	// Rows are separate allocations, so chunks are gathered into contiguous buffers first
+	template <numeric T> [[nodiscard]] T dot_unchecked(const column_vector<T>& x, const column_vector<T>& y) noexcept {
+		return reduce_chunks(x.size(), kernels::double_word<T> { 0, 0 }, [&x, &y](const std::size_t from, const std::size_t to) {
+			std::array<T, chunk_size> x_buffer;
+			std::array<T, chunk_size> y_buffer;
+
+			gather(x, from, to, x_buffer.data());
+			gather(y, from, to, y_buffer.data());
+
+			return kernels::dot2(x_buffer.data(), y_buffer.data(), to - from);
+		}, add<T>).value();
+	}
+
+	template <numeric T> [[nodiscard]] T nrm2(const column_vector<T>& x) noexcept {
+		const auto largest = reduce_chunks(x.size(), T(0), [&x](const std::size_t from, const std::size_t to) {
+			T result = 0;
+
+			for (auto i = from; i < to; ++i)
+				result = larger(result, std::abs(x.get_unchecked(i)));
+
+			return result;
+		}, larger<T>);
+
+		return scaled_norm(x.size(), largest, [&x](const std::size_t from, const std::size_t to, T* const buffer) {
+			gather(x, from, to, buffer);
+			return static_cast<const T*>(buffer);
+		});
+	}
+
+	template <numeric T> [[nodiscard]] bool axpy(const T alpha, const column_vector<T>& x, column_vector<T>& y) noexcept {
+		if (x.size() != y.size())
+			return false;
+
+		axpy_unchecked(alpha, x, y);
+		return true;
+	}
+
+	template <numeric T> void axpy_unchecked(const T alpha, const column_vector<T>& x, column_vector<T>& y) noexcept {
+		for_chunks(x.size(), [alpha, &x, &y](const std::size_t from, const std::size_t to) {
+			for (auto i = from; i < to; ++i)
+				y.get_unchecked(i) += alpha * x.get_unchecked(i);
+		});
+	}
+
+	template <numeric T> void scal(const T alpha, column_vector<T>& x) noexcept {
+		for_chunks(x.size(), [alpha, &x](const std::size_t from, const std::size_t to) {
+			for (auto i = from; i < to; ++i)
+				x.get_unchecked(i) *= alpha;
+		});
+	}
+
+	template double dot(const double* x, const double* y, std::size_t size) noexcept;
+	template double nrm2(const double* x, std::size_t size) noexcept;
+	template void axpy(double alpha, const double* x, double* y, std::size_t size) noexcept;
+	template void scal(double alpha, double* x, std::size_t size) noexcept;
+
+	template std::optional<double> dot(const column_vector<double>& x, const column_vector<double>& y) noexcept;
+	template double dot_unchecked(const column_vector<double>& x, const column_vector<double>& y) noexcept;
+	template double nrm2(const column_vector<double>& x) noexcept;
+	template bool axpy(double alpha, const column_vector<double>& x, column_vector<double>& y) noexcept;
+	template void axpy_unchecked(double alpha, const column_vector<double>& x, column_vector<double>& y) noexcept;
+	template void scal(double alpha, column_vector<double>& x) noexcept;
+
+	template float dot(const float* x, const float* y, std::size_t size) noexcept;
+	template float nrm2(const float* x, std::size_t size) noexcept;
+	template void axpy(float alpha, const float* x, float* y, std::size_t size) noexcept;
+	template void scal(float alpha, float* x, std::size_t size) noexcept;
+
+	template std::optional<float> dot(const column_vector<float>& x, const column_vector<float>& y) noexcept;
+	template float dot_unchecked(const column_vector<float>& x, const column_vector<float>& y) noexcept;
+	template float nrm2(const column_vector<float>& x) noexcept;
+	template bool axpy(float alpha, const column_vector<float>& x, column_vector<float>& y) noexcept;
+	template void axpy_unchecked(float alpha, const column_vector<float>& x, column_vector<float>& y) noexcept;
+	template void scal(float alpha, column_vector<float>& x) noexcept;
+
+	template long double dot(const long double* x, const long double* y, std::size_t size) noexcept;
+	template long double nrm2(const long double* x, std::size_t size) noexcept;
+	template void axpy(long double alpha, const long double* x, long double* y, std::size_t size) noexcept;
+	template void scal(long double alpha, long double* x, std::size_t size) noexcept;
+
+	template std::optional<long double> dot(const column_vector<long double>& x, const column_vector<long double>& y) noexcept;
+	template long double dot_unchecked(const column_vector<long double>& x, const column_vector<long double>& y) noexcept;
+	template long double nrm2(const column_vector<long double>& x) noexcept;
+	template bool axpy(long double alpha, const column_vector<long double>& x, column_vector<long double>& y) noexcept;
+	template void axpy_unchecked(long double alpha, const column_vector<long double>& x, column_vector<long double>& y) noexcept;
+	template void scal(long double alpha, column_vector<long double>& x) noexcept;
+} // agla::mtx::blas
@@ -0,0 +1,40 @@
+#ifndef BLAS_HPP
+#define BLAS_HPP
+
+#include "column_vector.hpp"
+
+namespace agla::mtx::blas {
+
+	// Level 1 operations for residuals and norms. Reductions use the compensated dot2 kernel
+	// over fixed chunks whose partial sums are merged in order, so results are as if computed
+	// in twice the working precision and do not depend on the thread count. Pointer forms
+	// serve matrix rows through get_unchecked(i).data()
+
+	// ----------------------- Contiguous -----------------------
+
+	// Elements per partial sum; fixed, so that the summation order is too
+	constexpr std::size_t chunk_size = 1 << 12;
+
+	template <numeric T> [[nodiscard]] T dot(const T* x, const T* y, std::size_t size) noexcept;
+
+	// Euclidean norm, scaled by a power of two when the squares would overflow or underflow
+	template <numeric T> [[nodiscard]] T nrm2(const T* x, std::size_t size) noexcept;
+
+	template <numeric T> void axpy(T alpha, const T* x, T* y, std::size_t size) noexcept;
+	template <numeric T> void scal(T alpha, T* x, std::size_t size) noexcept;
+
+	// ----------------------- Column vectors -----------------------
+
+	// Nullopt or false when the sizes differ
+	template <numeric T> [[nodiscard]] std::optional<T> dot(const column_vector<T>& x, const column_vector<T>& y) noexcept;
+	template <numeric T> [[nodiscard]] T dot_unchecked(const column_vector<T>& x, const column_vector<T>& y) noexcept;
+
+	template <numeric T> [[nodiscard]] T nrm2(const column_vector<T>& x) noexcept;
+
+	template <numeric T> [[nodiscard]] bool axpy(T alpha, const column_vector<T>& x, column_vector<T>& y) noexcept;
+	template <numeric T> void axpy_unchecked(T alpha, const column_vector<T>& x, column_vector<T>& y) noexcept;
+
+	template <numeric T> void scal(T alpha, column_vector<T>& x) noexcept;
+} // agla::mtx::blas
+
+#endif // BLAS_HPP
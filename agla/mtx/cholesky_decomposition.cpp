@@ -0,0 +1,281 @@
+#include <cmath>
+
+#include "cholesky_decomposition.hpp"
+#include "kernels.hpp"
+#include "norm_estimate.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::mtx {
+
+	// ----------------------- Constructors -----------------------
+
+	template <numeric T> cholesky_decomposition<T>::cholesky_decomposition(square_matrix<T>&& lower) noexcept : lower(std::move(lower)) {}
+
+	template <numeric T> [[nodiscard]] std::optional<cholesky_decomposition<T>> cholesky_decomposition<T>::from_square_matrix(const square_matrix<T>& mtx) noexcept {
+		auto lower = mtx;
+		return from_square_matrix(std::move(lower));
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<cholesky_decomposition<T>> cholesky_decomposition<T>::from_square_matrix(square_matrix<T>&& mtx) noexcept {
+		if (!factorize_in_place(mtx))
+			return std::nullopt;
+
+		return std::make_optional(cholesky_decomposition(std::move(mtx)));
+	}
+
+	// ----------------------- In-place kernels -----------------------
+
+	template <numeric T> [[nodiscard]] bool cholesky_decomposition<T>::factorize_in_place(square_matrix<T>& mtx) noexcept {
+		const auto size = mtx.size();
+
+		AGLA_INSTRUMENT(cholesky_factorize, size, size, size * size * size / 3, 2 * size * size * sizeof(T));
+
+		auto& pool = par::thread_pool::instance();
+		std::vector<T> work(size);
+
+		for (std::size_t k = 0; k < size; ++k) {
+			auto& diag = mtx.get_unchecked(k).get_unchecked(k);
+
+			if (!(diag > 0))
+				return false;
+
+			diag = std::sqrt(diag);
+
+			// Column k is gathered once so the trailing update only touches contiguous rows
+			for (std::size_t i = k + 1; i < size; ++i)
+				work[i] = mtx.get_unchecked(i).get_unchecked(k) /= diag;
+
+			pool.parallel_for(k + 1, size, par::thread_pool::grain_for(size - k), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t i = from; i < to; ++i)
+					kernels::axpy(-work[i], work.data() + k + 1, mtx.get_unchecked(i).data() + k + 1, i - k);
+			});
+		}
+
+		for (std::size_t i = 0; i < size; ++i) {
+			auto* const row = mtx.get_unchecked(i).data();
+			std::fill(row + i + 1, row + size, T(0));
+		}
+
+		return true;
+	}
+
+	template <numeric T> void cholesky_decomposition<T>::invert_in_place(square_matrix<T>& lower) noexcept {
+		const auto size = lower.size();
+
+		AGLA_INSTRUMENT(cholesky_invert, size, size, 2 * size * size * size / 3, 2 * size * size * sizeof(T));
+
+		auto& pool = par::thread_pool::instance();
+		std::vector<T> work(size);
+
+		// W = L^-1 row by row from the top, each row accumulated across column panels
+
+		for (std::size_t i = 0; i < size; ++i) {
+			auto* const row_i = lower.get_unchecked(i).data();
+			const auto inv_diag = 1 / row_i[i];
+
+			pool.parallel_for(0, i, par::thread_pool::grain_for(i), [&](const std::size_t from, const std::size_t to) {
+				std::fill(work.begin() + from, work.begin() + to, T(0));
+
+				for (std::size_t k = from; k < i; ++k)
+					kernels::axpy(row_i[k], lower.get_unchecked(k).data() + from, work.data() + from, std::min(k + 1, to) - from);
+			});
+
+			for (std::size_t q = 0; q < i; ++q)
+				row_i[q] = -work[q] * inv_diag;
+
+			row_i[i] = inv_diag;
+		}
+
+		// A^-1 = W^T * W; row i only needs rows i.. of W, so it can overwrite W[i]
+
+		for (std::size_t i = 0; i < size; ++i) {
+			pool.parallel_for(0, i + 1, par::thread_pool::grain_for(size - i), [&](const std::size_t from, const std::size_t to) {
+				std::fill(work.begin() + from, work.begin() + to, T(0));
+
+				for (std::size_t k = i; k < size; ++k) {
+					const auto* const row_k = lower.get_unchecked(k).data();
+					kernels::axpy(row_k[i], row_k + from, work.data() + from, to - from);
+				}
+			});
+
+			std::copy(work.begin(), work.begin() + i + 1, lower.get_unchecked(i).data());
+		}
+
+		pool.parallel_for(0, size, par::thread_pool::grain_for(size), [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t i = from; i < to; ++i) {
+				auto* const row_i = lower.get_unchecked(i).data();
+
+				for (std::size_t q = i + 1; q < size; ++q)
+					row_i[q] = lower.get_unchecked(q).get_unchecked(i);
+			}
+		});
+	}
+
+	// ----------------------- Accessors -----------------------
+
+	template <numeric T> [[nodiscard]] inline std::size_t cholesky_decomposition<T>::size() const noexcept {
+		return lower.size();
+	}
+
+	template <numeric T> [[nodiscard]] inline const square_matrix<T>& cholesky_decomposition<T>::lower_triangular() const noexcept {
+		return lower;
+	}
+
+	// ----------------------- Operations -----------------------
+
+	template <numeric T> [[nodiscard]] inline column_vector<T> cholesky_decomposition<T>::solve_unchecked(const column_vector<T>& b) const noexcept {
+		const auto sz = size();
+		std::vector<T> buf(sz);
+
+		for (std::size_t i = 0; i < sz; ++i)
+			buf[i] = b.get_unchecked(i);
+
+		solve_in_place(buf.data());
+
+		column_vector<T> result(sz);
+
+		for (std::size_t i = 0; i < sz; ++i)
+			result.get_unchecked(i) = buf[i];
+
+		return result;
+	}
+
+	template <numeric T> inline void cholesky_decomposition<T>::solve_in_place(T* const b) const noexcept {
+		const auto sz = size();
+
+		for (std::size_t i = 0; i < sz; ++i) {
+			const auto& lower_i = lower.get_unchecked(i);
+			b[i] = (b[i] - kernels::dot(lower_i.data(), b, i)) / lower_i.get_unchecked(i);
+		}
+
+		for (std::size_t i = sz; i-- > 0;) {
+			const auto& lower_i = lower.get_unchecked(i);
+			b[i] /= lower_i.get_unchecked(i);
+			kernels::axpy(-b[i], lower_i.data(), b, i);
+		}
+	}
+
+	template <numeric T> [[nodiscard]] inline T cholesky_decomposition<T>::log_determinant() const noexcept {
+		T acc = 0;
+
+		for (std::size_t i = 0; i < size(); ++i)
+			acc += std::log(lower.get_unchecked(i).get_unchecked(i));
+
+		return 2 * acc;
+	}
+
+	template <numeric T> [[nodiscard]] inline T cholesky_decomposition<T>::condition_estimate(const T one_norm) const noexcept {
+		// A^-1 is symmetric, so both solves are the same
+		const auto solve = [this](T* const x) { solve_in_place(x); };
+		return one_norm * inverse_one_norm_estimate<T>(size(), solve, solve);
+	}
+
+	// ----------------------- Rank-1 modifications -----------------------
+
+	template <numeric T> inline void cholesky_decomposition<T>::update_unchecked(T* const x) noexcept {
+		const auto sz = size();
+
+		for (std::size_t k = 0; k < sz; ++k) {
+			auto& diag = lower.get_unchecked(k).get_unchecked(k);
+			const auto r = std::hypot(diag, x[k]);
+			const auto c = r / diag;
+			const auto s = x[k] / diag;
+			diag = r;
+
+			for (std::size_t i = k + 1; i < sz; ++i) {
+				auto& l = lower.get_unchecked(i).get_unchecked(k);
+				l = (l + s * x[i]) / c;
+				x[i] = c * x[i] - s * l;
+			}
+		}
+	}
+
+	template <numeric T> [[nodiscard]] inline bool cholesky_decomposition<T>::downdate_unchecked(T* const x) noexcept {
+		const auto sz = size();
+
+		for (std::size_t k = 0; k < sz; ++k) {
+			auto& diag = lower.get_unchecked(k).get_unchecked(k);
+			const auto squared = (diag - x[k]) * (diag + x[k]);
+
+			if (!(squared > 0))
+				return false;
+
+			const auto r = std::sqrt(squared);
+			const auto c = r / diag;
+			const auto s = x[k] / diag;
+			diag = r;
+
+			for (std::size_t i = k + 1; i < sz; ++i) {
+				auto& l = lower.get_unchecked(i).get_unchecked(k);
+				l = (l - s * x[i]) / c;
+				x[i] = c * x[i] - s * l;
+			}
+		}
+
+		return true;
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	template cholesky_decomposition<double>::cholesky_decomposition(square_matrix<double>&& lower) noexcept;
+	template std::optional<cholesky_decomposition<double>> cholesky_decomposition<double>::from_square_matrix(const square_matrix<double>& mtx) noexcept;
+	template std::optional<cholesky_decomposition<double>> cholesky_decomposition<double>::from_square_matrix(square_matrix<double>&& mtx) noexcept;
+
+	template cholesky_decomposition<float>::cholesky_decomposition(square_matrix<float>&& lower) noexcept;
+	template std::optional<cholesky_decomposition<float>> cholesky_decomposition<float>::from_square_matrix(const square_matrix<float>& mtx) noexcept;
+	template std::optional<cholesky_decomposition<float>> cholesky_decomposition<float>::from_square_matrix(square_matrix<float>&& mtx) noexcept;
+
+	template cholesky_decomposition<long double>::cholesky_decomposition(square_matrix<long double>&& lower) noexcept;
+	template std::optional<cholesky_decomposition<long double>> cholesky_decomposition<long double>::from_square_matrix(const square_matrix<long double>& mtx) noexcept;
+	template std::optional<cholesky_decomposition<long double>> cholesky_decomposition<long double>::from_square_matrix(square_matrix<long double>&& mtx) noexcept;
+
+	// ----------------------- In-place kernels -----------------------
+
+	template bool cholesky_decomposition<double>::factorize_in_place(square_matrix<double>& mtx) noexcept;
+	template void cholesky_decomposition<double>::invert_in_place(square_matrix<double>& lower) noexcept;
+
+	template bool cholesky_decomposition<float>::factorize_in_place(square_matrix<float>& mtx) noexcept;
+	template void cholesky_decomposition<float>::invert_in_place(square_matrix<float>& lower) noexcept;
+
+	template bool cholesky_decomposition<long double>::factorize_in_place(square_matrix<long double>& mtx) noexcept;
+	template void cholesky_decomposition<long double>::invert_in_place(square_matrix<long double>& lower) noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t cholesky_decomposition<double>::size() const noexcept;
+	template const square_matrix<double>& cholesky_decomposition<double>::lower_triangular() const noexcept;
+
+	template std::size_t cholesky_decomposition<float>::size() const noexcept;
+	template const square_matrix<float>& cholesky_decomposition<float>::lower_triangular() const noexcept;
+
+	template std::size_t cholesky_decomposition<long double>::size() const noexcept;
+	template const square_matrix<long double>& cholesky_decomposition<long double>::lower_triangular() const noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template column_vector<double> cholesky_decomposition<double>::solve_unchecked(const column_vector<double>& b) const noexcept;
+	template void cholesky_decomposition<double>::solve_in_place(double* b) const noexcept;
+	template double cholesky_decomposition<double>::log_determinant() const noexcept;
+	template double cholesky_decomposition<double>::condition_estimate(double one_norm) const noexcept;
+
+	template column_vector<float> cholesky_decomposition<float>::solve_unchecked(const column_vector<float>& b) const noexcept;
+	template void cholesky_decomposition<float>::solve_in_place(float* b) const noexcept;
+	template float cholesky_decomposition<float>::log_determinant() const noexcept;
+	template float cholesky_decomposition<float>::condition_estimate(float one_norm) const noexcept;
+
+	template column_vector<long double> cholesky_decomposition<long double>::solve_unchecked(const column_vector<long double>& b) const noexcept;
+	template void cholesky_decomposition<long double>::solve_in_place(long double* b) const noexcept;
+	template long double cholesky_decomposition<long double>::log_determinant() const noexcept;
+	template long double cholesky_decomposition<long double>::condition_estimate(long double one_norm) const noexcept;
+
+	// ----------------------- Rank-1 modifications -----------------------
+
+	template void cholesky_decomposition<double>::update_unchecked(double* x) noexcept;
+	template bool cholesky_decomposition<double>::downdate_unchecked(double* x) noexcept;
+
+	template void cholesky_decomposition<float>::update_unchecked(float* x) noexcept;
+	template bool cholesky_decomposition<float>::downdate_unchecked(float* x) noexcept;
+
+	template void cholesky_decomposition<long double>::update_unchecked(long double* x) noexcept;
+	template bool cholesky_decomposition<long double>::downdate_unchecked(long double* x) noexcept;
+} // agla::mtx
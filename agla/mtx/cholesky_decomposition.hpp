@@ -0,0 +1,55 @@
+#ifndef CHOLESKY_DECOMPOSITION_HPP
+#define CHOLESKY_DECOMPOSITION_HPP
+
+#include "column_vector.hpp"
+
+namespace agla::mtx {
+	template <numeric T> class cholesky_decomposition {
+		square_matrix<T> lower;
+
+		explicit cholesky_decomposition(square_matrix<T>&& lower) noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		[[nodiscard]] static std::optional<cholesky_decomposition> from_square_matrix(const square_matrix<T>& mtx) noexcept;
+		[[nodiscard]] static std::optional<cholesky_decomposition> from_square_matrix(square_matrix<T>&& mtx) noexcept;
+
+		// ----------------------- In-place kernels -----------------------
+
+		// Overwrites the lower triangle with L and zeroes the upper one.
+		// Returns false if mtx is not positive definite
+		[[nodiscard]] static bool factorize_in_place(square_matrix<T>& mtx) noexcept;
+
+		// Overwrites L with (L * L^T)^-1 using O(n) extra memory
+		static void invert_in_place(square_matrix<T>& lower) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t size() const noexcept;
+		[[nodiscard]] inline const square_matrix<T>& lower_triangular() const noexcept;
+
+		// ----------------------- Operations -----------------------
+
+		[[nodiscard]] inline column_vector<T> solve_unchecked(const column_vector<T>& b) const noexcept;
+		inline void solve_in_place(T* b) const noexcept;
+
+		// log det = 2 * sum(log l_ii); the determinant of an SPD matrix is always positive
+		[[nodiscard]] inline T log_determinant() const noexcept;
+
+		// Estimated kappa_1(A) = ||A||_1 * ||A^-1||_1, given ||A||_1 of the factorized matrix
+		[[nodiscard]] inline T condition_estimate(T one_norm) const noexcept;
+
+		// ----------------------- Rank-1 modifications -----------------------
+
+		// Refactors to A + x * x^T in O(n^2) with Givens rotations; x is used as workspace
+		inline void update_unchecked(T* x) noexcept;
+
+		// Refactors to A - x * x^T with hyperbolic rotations. Returns false when the result is
+		// not numerically positive definite, leaving the factor unspecified
+		[[nodiscard]] inline bool downdate_unchecked(T* x) noexcept;
+	};
+} // agla::mtx
+
+#endif // CHOLESKY_DECOMPOSITION_HPP
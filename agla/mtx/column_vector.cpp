@@ -1,17 +1,15 @@
-#include <numeric>
-#include <cmath>
-
 #include "column_vector.hpp"
+#include "blas.hpp"
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "HidingNonVirtualFunction"
 
 namespace agla::mtx {
-	template <numeric T> column_vector<T>::column_vector(const std::size_t size) noexcept : mtx::matrix<T>(size, 1) {}
+	template <numeric T> column_vector<T>::column_vector(const std::size_t size, const typename matrix<T>::allocator_type& allocator) noexcept : mtx::matrix<T>(size, 1, allocator) {}
 	template <numeric T> column_vector<T>::column_vector(const mtx::matrix<T>& mtx) noexcept : mtx::matrix<T>(mtx) {}
-	template <numeric T> column_vector<T>::column_vector(mtx::matrix<T>&& mtx) noexcept : mtx::matrix<T>(mtx) {}
-	template <numeric T> column_vector<T>::column_vector(const std::size_t size, const T& elem) noexcept : mtx::matrix<T>(size, std::vector<T> { elem }) {}
-	template <numeric T> column_vector<T>::column_vector(const std::size_t size, T&& elem) noexcept : mtx::matrix<T>(size, std::vector<T> { elem }) {}
+	template <numeric T> column_vector<T>::column_vector(mtx::matrix<T>&& mtx) noexcept : mtx::matrix<T>(std::move(mtx)) {}
+	template <numeric T> column_vector<T>::column_vector(const std::size_t size, const T& elem, const typename matrix<T>::allocator_type& allocator) noexcept : mtx::matrix<T>(size, std::vector<T> { elem }, allocator) {}
+	template <numeric T> column_vector<T>::column_vector(const std::size_t size, T&& elem, const typename matrix<T>::allocator_type& allocator) noexcept : mtx::matrix<T>(size, std::vector<T> { elem }, allocator) {}
 
 	template <numeric T> [[nodiscard]] inline std::size_t column_vector<T>::size() const noexcept {
 		return this->rows_number();
@@ -23,7 +21,7 @@ namespace agla::mtx {
 		if (rows != other.rows_number())
 			return std::nullopt;
 
-		column_vector result(rows);
+		column_vector result(rows, this->get_allocator());
 
 		auto this_it = this->begin();
 		auto other_it = other.begin();
@@ -40,7 +38,7 @@ namespace agla::mtx {
 		if (size() != other.size())
 			return std::nullopt;
 
-		column_vector result(size());
+		column_vector result(size(), this->get_allocator());
 
 		auto this_it = this->begin();
 		auto other_it = other.begin();
@@ -61,17 +59,15 @@ namespace agla::mtx {
 		return this->mtx[index].get_unchecked(0);
 	}
 
-	template <numeric T> [[nodiscard]] inline double column_vector<T>::norm() const noexcept {
-		return std::sqrt(std::accumulate(this->begin(), this->end(), 0.0, [](const auto& acc, const auto& x) {
-			return acc + x * x;
-		}));
+	template <numeric T> [[nodiscard]] inline T column_vector<T>::norm() const noexcept {
+		return blas::nrm2(*this);
 	}
 
-	template column_vector<double>::column_vector(std::size_t size) noexcept;
+	template column_vector<double>::column_vector(std::size_t size, const matrix<double>::allocator_type& allocator) noexcept;
 	template column_vector<double>::column_vector(const mtx::matrix<double>& mtx) noexcept;
 	template column_vector<double>::column_vector(mtx::matrix<double>&& mtx) noexcept;
-	template column_vector<double>::column_vector(std::size_t size, const double& elem) noexcept;
-	template column_vector<double>::column_vector(std::size_t size, double && elem) noexcept;
+	template column_vector<double>::column_vector(std::size_t size, const double& elem, const matrix<double>::allocator_type& allocator) noexcept;
+	template column_vector<double>::column_vector(std::size_t size, double && elem, const matrix<double>::allocator_type& allocator) noexcept;
 
 	template std::size_t column_vector<double>::size() const noexcept;
 
@@ -82,6 +78,38 @@ namespace agla::mtx {
 	template const double& column_vector<double>::get_unchecked(std::size_t index) const noexcept;
 
 	template double column_vector<double>::norm() const noexcept;
+
+	template column_vector<float>::column_vector(std::size_t size, const matrix<float>::allocator_type& allocator) noexcept;
+	template column_vector<float>::column_vector(const mtx::matrix<float>& mtx) noexcept;
+	template column_vector<float>::column_vector(mtx::matrix<float>&& mtx) noexcept;
+	template column_vector<float>::column_vector(std::size_t size, const float& elem, const matrix<float>::allocator_type& allocator) noexcept;
+	template column_vector<float>::column_vector(std::size_t size, float && elem, const matrix<float>::allocator_type& allocator) noexcept;
+
+	template std::size_t column_vector<float>::size() const noexcept;
+
+	template std::optional<column_vector<float>> column_vector<float>::operator+(const column_vector& other) const noexcept;
+	template std::optional<column_vector<float>> column_vector<float>::operator-(const column_vector& other) const noexcept;
+
+	template float& column_vector<float>::get_unchecked(std::size_t index) noexcept;
+	template const float& column_vector<float>::get_unchecked(std::size_t index) const noexcept;
+
+	template float column_vector<float>::norm() const noexcept;
+
+	template column_vector<long double>::column_vector(std::size_t size, const matrix<long double>::allocator_type& allocator) noexcept;
+	template column_vector<long double>::column_vector(const mtx::matrix<long double>& mtx) noexcept;
+	template column_vector<long double>::column_vector(mtx::matrix<long double>&& mtx) noexcept;
+	template column_vector<long double>::column_vector(std::size_t size, const long double& elem, const matrix<long double>::allocator_type& allocator) noexcept;
+	template column_vector<long double>::column_vector(std::size_t size, long double && elem, const matrix<long double>::allocator_type& allocator) noexcept;
+
+	template std::size_t column_vector<long double>::size() const noexcept;
+
+	template std::optional<column_vector<long double>> column_vector<long double>::operator+(const column_vector& other) const noexcept;
+	template std::optional<column_vector<long double>> column_vector<long double>::operator-(const column_vector& other) const noexcept;
+
+	template long double& column_vector<long double>::get_unchecked(std::size_t index) noexcept;
+	template const long double& column_vector<long double>::get_unchecked(std::size_t index) const noexcept;
+
+	template long double column_vector<long double>::norm() const noexcept;
 } // agla::mtx
 
 #pragma clang diagnostic pop
\ No newline at end of file
@@ -12,9 +12,9 @@ namespace agla::mtx {
 		explicit column_vector(mtx::matrix<T>&& mtx) noexcept;
 
 	 public:
-		explicit column_vector(std::size_t size) noexcept;
-		column_vector(std::size_t size, const T& elem) noexcept;
-		column_vector(std::size_t size, T&& elem) noexcept;
+		explicit column_vector(std::size_t size, const typename matrix<T>::allocator_type& allocator = {}) noexcept;
+		column_vector(std::size_t size, const T& elem, const typename matrix<T>::allocator_type& allocator = {}) noexcept;
+		column_vector(std::size_t size, T&& elem, const typename matrix<T>::allocator_type& allocator = {}) noexcept;
 
 		static inline column_vector<T> from_matrix_unchecked(const matrix<T>& mtx) noexcept {
 			return column_vector(mtx);
@@ -55,7 +55,8 @@ namespace agla::mtx {
 		[[nodiscard]] inline T& get_unchecked(std::size_t index) noexcept;
 		[[nodiscard]] inline const T& get_unchecked(std::size_t index) const noexcept;
 
-		[[nodiscard]] inline double norm() const noexcept;
+		// Euclidean norm without overflow or cancellation, see blas::nrm2
+		[[nodiscard]] inline T norm() const noexcept;
 	};
 } // agla::mtx
 
@@ -18,4 +18,10 @@ namespace agla::mtx {
 
 	template elimination_matrix<double>::elimination_matrix(const square_matrix<double>& mtx, std::size_t row_ind, std::size_t column_ind) noexcept;
 	template elimination_matrix<double>& elimination_matrix<double>::operator=(const elimination_matrix& matrix) noexcept;
+
+	template elimination_matrix<float>::elimination_matrix(const square_matrix<float>& mtx, std::size_t row_ind, std::size_t column_ind) noexcept;
+	template elimination_matrix<float>& elimination_matrix<float>::operator=(const elimination_matrix& matrix) noexcept;
+
+	template elimination_matrix<long double>::elimination_matrix(const square_matrix<long double>& mtx, std::size_t row_ind, std::size_t column_ind) noexcept;
+	template elimination_matrix<long double>& elimination_matrix<long double>::operator=(const elimination_matrix& matrix) noexcept;
 } // mtx
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace agla::mtx {
 	template <numeric T> identity_matrix<T>::identity_matrix(const square_matrix<T>& mtx) noexcept : square_matrix<T>(mtx) {}
 	template <numeric T> identity_matrix<T>::identity_matrix(square_matrix<T>&& mtx) noexcept : square_matrix<T>(mtx) {}
 
-	template <numeric T> identity_matrix<T>::identity_matrix(const std::size_t size) noexcept : square_matrix<T>(size, std::vector<T>(size, 0)) {
+	template <numeric T> identity_matrix<T>::identity_matrix(const std::size_t size, const typename matrix<T>::allocator_type& allocator) noexcept : square_matrix<T>(size, T(0), allocator) {
 		for (std::size_t i = 0; i < size; ++i)
 			this->get_unchecked(i).get_unchecked(i) = 1;
 	}
@@ -28,11 +28,27 @@ namespace agla::mtx {
 
 	template identity_matrix<double>::identity_matrix(const square_matrix<double>& mtx) noexcept;
 	template identity_matrix<double>::identity_matrix(square_matrix<double>&& mtx) noexcept;
-	template identity_matrix<double>::identity_matrix(std::size_t size) noexcept;
+	template identity_matrix<double>::identity_matrix(std::size_t size, const matrix<double>::allocator_type& allocator) noexcept;
 
 	template identity_matrix<double>& identity_matrix<double>::operator=(const identity_matrix& matrix) noexcept;
 	template matrix<double>::matrix_row& identity_matrix<double>::get_unchecked(std::size_t index) noexcept;
 	template std::optional<std::reference_wrapper<matrix<double>::matrix_row>> identity_matrix<double>::operator[](std::size_t index) noexcept;
+
+	template identity_matrix<float>::identity_matrix(const square_matrix<float>& mtx) noexcept;
+	template identity_matrix<float>::identity_matrix(square_matrix<float>&& mtx) noexcept;
+	template identity_matrix<float>::identity_matrix(std::size_t size, const matrix<float>::allocator_type& allocator) noexcept;
+
+	template identity_matrix<float>& identity_matrix<float>::operator=(const identity_matrix& matrix) noexcept;
+	template matrix<float>::matrix_row& identity_matrix<float>::get_unchecked(std::size_t index) noexcept;
+	template std::optional<std::reference_wrapper<matrix<float>::matrix_row>> identity_matrix<float>::operator[](std::size_t index) noexcept;
+
+	template identity_matrix<long double>::identity_matrix(const square_matrix<long double>& mtx) noexcept;
+	template identity_matrix<long double>::identity_matrix(square_matrix<long double>&& mtx) noexcept;
+	template identity_matrix<long double>::identity_matrix(std::size_t size, const matrix<long double>::allocator_type& allocator) noexcept;
+
+	template identity_matrix<long double>& identity_matrix<long double>::operator=(const identity_matrix& matrix) noexcept;
+	template matrix<long double>::matrix_row& identity_matrix<long double>::get_unchecked(std::size_t index) noexcept;
+	template std::optional<std::reference_wrapper<matrix<long double>::matrix_row>> identity_matrix<long double>::operator[](std::size_t index) noexcept;
 } // agla::mtx
 
 #pragma clang diagnostic pop
\ No newline at end of file
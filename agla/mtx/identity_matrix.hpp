@@ -12,7 +12,7 @@ namespace agla::mtx {
 		explicit identity_matrix(square_matrix<T>&& mtx) noexcept;
 
 	 public:
-		explicit identity_matrix(std::size_t size) noexcept;
+		explicit identity_matrix(std::size_t size, const typename matrix<T>::allocator_type& allocator = {}) noexcept;
 
 		inline identity_matrix& operator=(const identity_matrix& matrix) noexcept;
 
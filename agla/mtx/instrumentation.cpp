@@ -0,0 +1,267 @@
+#include <atomic>
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "instrumentation.hpp"
+
+namespace agla::mtx::instrumentation {
+	namespace {
+		struct trace_event {
+			operation op;
+			std::size_t rows;
+			std::size_t columns;
+			std::uint64_t start_nanoseconds;
+			std::uint64_t nanoseconds;
+			std::uint64_t flops;
+			std::uint64_t bytes;
+		};
+
+		// Owned by the registry, so counters survive the thread that wrote them
+		struct thread_record {
+			std::size_t index;
+			std::mutex mutex;
+			std::unordered_map<std::uint32_t, counters> stats;
+			std::vector<trace_event> events;
+
+			explicit thread_record(const std::size_t index) noexcept : index(index) {}
+		};
+
+		struct registry {
+			std::mutex mutex;
+			std::vector<std::unique_ptr<thread_record>> threads;
+			std::atomic<bool> tracing { false };
+			const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+		};
+
+		registry& global() noexcept {
+			static registry instance;
+			return instance;
+		}
+
+		thread_record& local() noexcept {
+			thread_local thread_record* const record = [] {
+				auto& reg = global();
+				std::lock_guard lock(reg.mutex);
+				reg.threads.push_back(std::make_unique<thread_record>(reg.threads.size()));
+				return reg.threads.back().get();
+			}();
+
+			return *record;
+		}
+
+		thread_local scope* current = nullptr;
+
+		[[nodiscard]] std::uint32_t bucket(const std::size_t extent) noexcept {
+			return static_cast<std::uint32_t>(std::bit_width(extent));
+		}
+
+		[[nodiscard]] std::uint32_t key(const operation op, const std::size_t rows, const std::size_t columns) noexcept {
+			return static_cast<std::uint32_t>(op) << 16 | bucket(rows) << 8 | bucket(columns);
+		}
+
+		// Bucket b holds extents in [2^(b-1), 2^b - 1]
+		void write_bucket(std::ostream& out, const std::uint32_t b) {
+			if (b == 0) {
+				out << "\"0\"";
+				return;
+			}
+
+			out << "\"" << (std::uint64_t(1) << (b - 1)) << "-" << ((std::uint64_t(1) << b) - 1) << "\"";
+		}
+
+		void write_entries(std::ostream& out, const std::map<std::uint32_t, counters>& stats) {
+			out << "[";
+
+			for (auto it = stats.begin(); it != stats.end(); ++it) {
+				const auto& [k, c] = *it;
+				const auto seconds = static_cast<double>(c.nanoseconds) * 1e-9;
+
+				out << (it == stats.begin() ? "" : ",")
+					<< "{\"operation\":\"" << name(static_cast<operation>(k >> 16)) << "\",\"rows\":";
+
+				write_bucket(out, k >> 8 & 0xFF);
+				out << ",\"columns\":";
+				write_bucket(out, k & 0xFF);
+
+				out << ",\"calls\":" << c.calls
+					<< ",\"seconds\":" << seconds
+					<< ",\"flops\":" << c.flops
+					<< ",\"bytes\":" << c.bytes
+					<< ",\"allocations\":" << c.allocations
+					<< ",\"allocated_bytes\":" << c.allocated_bytes
+					<< ",\"gflops_per_second\":" << (seconds > 0 ? static_cast<double>(c.flops) * 1e-9 / seconds : 0.0)
+					<< "}";
+			}
+
+			out << "]";
+		}
+	}
+
+	[[nodiscard]] const char* name(const operation op) noexcept {
+		switch (op) {
+			case operation::add: return "add";
+			case operation::sub: return "sub";
+			case operation::mul: return "mul";
+			case operation::mul_transposed: return "mul_transposed";
+			case operation::mul_strassen: return "mul_strassen";
+			case operation::transpose: return "transpose";
+			case operation::transpose_in_place: return "transpose_in_place";
+			case operation::lu_factorize: return "lu_factorize";
+			case operation::lu_invert: return "lu_invert";
+			case operation::cholesky_factorize: return "cholesky_factorize";
+			case operation::cholesky_invert: return "cholesky_invert";
+			case operation::qr_factorize: return "qr_factorize";
+			case operation::svd_factorize: return "svd_factorize";
+			case operation::read: return "read";
+			case operation::write: return "write";
+		}
+
+		return "unknown";
+	}
+
+	// ########################## Scope ##########################
+
+	scope::scope(
+		const operation op,
+		const std::size_t rows,
+		const std::size_t columns,
+		const std::uint64_t flops,
+		const std::uint64_t bytes
+	) noexcept : op(op), rows(rows), columns(columns), flops(flops), bytes(bytes), parent(current), start(std::chrono::steady_clock::now()) {
+		current = this;
+	}
+
+	scope::~scope() noexcept {
+		const auto finish = std::chrono::steady_clock::now();
+		const auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+
+		current = parent;
+
+		auto& record = local();
+		auto& reg = global();
+		std::lock_guard lock(record.mutex);
+
+		auto& c = record.stats[key(op, rows, columns)];
+		++c.calls;
+		c.nanoseconds += elapsed;
+		c.flops += flops;
+		c.bytes += bytes;
+		c.allocations += allocations;
+		c.allocated_bytes += allocated_bytes;
+
+		if (reg.tracing.load(std::memory_order_relaxed))
+			record.events.push_back(trace_event {
+				op,
+				rows,
+				columns,
+				static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(start - reg.epoch).count()),
+				elapsed,
+				flops,
+				bytes
+			});
+	}
+
+	void record_allocation(const std::size_t bytes) noexcept {
+		if (current == nullptr)
+			return;
+
+		++current->allocations;
+		current->allocated_bytes += bytes;
+	}
+
+	// ########################## Counting Resource ##########################
+
+	void* counting_resource::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+		record_allocation(bytes);
+		return upstream->allocate(bytes, alignment);
+	}
+
+	void counting_resource::do_deallocate(void* const ptr, const std::size_t bytes, const std::size_t alignment) {
+		upstream->deallocate(ptr, bytes, alignment);
+	}
+
+	[[nodiscard]] bool counting_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+
+	// ########################## Export ##########################
+
+	void set_tracing(const bool enabled) noexcept {
+		global().tracing.store(enabled);
+	}
+
+	void reset() noexcept {
+		auto& reg = global();
+		std::lock_guard lock(reg.mutex);
+
+		for (auto& record : reg.threads) {
+			std::lock_guard record_lock(record->mutex);
+			record->stats.clear();
+			record->events.clear();
+		}
+	}
+
+	void write_json(std::ostream& out) {
+		auto& reg = global();
+		std::lock_guard lock(reg.mutex);
+		std::map<std::uint32_t, counters> total;
+
+		out << "{\"threads\":[";
+
+		for (std::size_t i = 0; i < reg.threads.size(); ++i) {
+			auto& record = *reg.threads[i];
+			std::lock_guard record_lock(record.mutex);
+			const std::map<std::uint32_t, counters> sorted(record.stats.begin(), record.stats.end());
+
+			for (const auto& [k, c] : sorted) {
+				auto& sum = total[k];
+				sum.calls += c.calls;
+				sum.nanoseconds += c.nanoseconds;
+				sum.flops += c.flops;
+				sum.bytes += c.bytes;
+				sum.allocations += c.allocations;
+				sum.allocated_bytes += c.allocated_bytes;
+			}
+
+			out << (i == 0 ? "" : ",") << "{\"thread\":" << record.index << ",\"operations\":";
+			write_entries(out, sorted);
+			out << "}";
+		}
+
+		out << "],\"total\":";
+		write_entries(out, total);
+		out << "}\n";
+	}
+
+	void write_chrome_trace(std::ostream& out) {
+		auto& reg = global();
+		std::lock_guard lock(reg.mutex);
+		auto first = true;
+
+		out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+		for (const auto& record : reg.threads) {
+			std::lock_guard record_lock(record->mutex);
+
+			for (const auto& event : record->events) {
+				out << (first ? "" : ",\n")
+					<< "{\"name\":\"" << name(event.op)
+					<< "\",\"cat\":\"agla\",\"ph\":\"X\",\"pid\":0,\"tid\":" << record->index
+					<< ",\"ts\":" << static_cast<double>(event.start_nanoseconds) * 1e-3
+					<< ",\"dur\":" << static_cast<double>(event.nanoseconds) * 1e-3
+					<< ",\"args\":{\"rows\":" << event.rows
+					<< ",\"columns\":" << event.columns
+					<< ",\"flops\":" << event.flops
+					<< ",\"bytes\":" << event.bytes << "}}";
+
+				first = false;
+			}
+		}
+
+		out << "]}\n";
+	}
+} // agla::mtx::instrumentation
@@ -0,0 +1,109 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <ostream>
+
+// Hooks compile to nothing unless AGLA_ENABLE_INSTRUMENTATION is defined, so the default build pays
+// no cost. The collection and export API below stays available either way and simply reports nothing
+
+#ifdef AGLA_ENABLE_INSTRUMENTATION
+#define AGLA_INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define AGLA_INSTRUMENT_CONCAT(a, b) AGLA_INSTRUMENT_CONCAT_IMPL(a, b)
+#define AGLA_INSTRUMENT(op, rows, columns, flops, bytes) \
+	const ::agla::mtx::instrumentation::scope AGLA_INSTRUMENT_CONCAT(agla_instrumentation_scope_, __LINE__)( \
+		::agla::mtx::instrumentation::operation::op, rows, columns, flops, bytes \
+	)
+#else
+#define AGLA_INSTRUMENT(op, rows, columns, flops, bytes) static_cast<void>(0)
+#endif
+
+namespace agla::mtx::instrumentation {
+	enum class operation : std::uint8_t {
+		add,
+		sub,
+		mul,
+		mul_transposed,
+		mul_strassen,
+		transpose,
+		transpose_in_place,
+		lu_factorize,
+		lu_invert,
+		cholesky_factorize,
+		cholesky_invert,
+		qr_factorize,
+		svd_factorize,
+		read,
+		write
+	};
+
+	[[nodiscard]] const char* name(operation op) noexcept;
+
+	struct counters {
+		std::uint64_t calls = 0;
+		std::uint64_t nanoseconds = 0;
+		std::uint64_t flops = 0;
+		std::uint64_t bytes = 0;
+		std::uint64_t allocations = 0;
+		std::uint64_t allocated_bytes = 0;
+	};
+
+	// ########################## Scope ##########################
+
+	// Times one operation on the current thread; shapes are bucketed by powers of two.
+	// Nested scopes are inclusive, allocations are charged to the innermost one
+	class scope {
+		operation op;
+		std::size_t rows;
+		std::size_t columns;
+		std::uint64_t flops;
+		std::uint64_t bytes;
+		std::uint64_t allocations = 0;
+		std::uint64_t allocated_bytes = 0;
+		scope* parent;
+		std::chrono::steady_clock::time_point start;
+
+		friend void record_allocation(std::size_t bytes) noexcept;
+
+	 public:
+		scope(operation op, std::size_t rows, std::size_t columns, std::uint64_t flops, std::uint64_t bytes) noexcept;
+		~scope() noexcept;
+
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
+	};
+
+	void record_allocation(std::size_t bytes) noexcept;
+
+	// ########################## Counting Resource ##########################
+
+	// Forwards to upstream and charges every allocation to the running scope; install it with
+	// std::pmr::set_default_resource or pass it to matrix constructors
+	class counting_resource : public std::pmr::memory_resource {
+		std::pmr::memory_resource* upstream;
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+		[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	 public:
+		explicit counting_resource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept : upstream(upstream) {}
+	};
+
+	// ########################## Export ##########################
+
+	// Trace events are kept in memory until reset(), so tracing is off by default
+	void set_tracing(bool enabled) noexcept;
+	void reset() noexcept;
+
+	// Per-thread and total counters for every (operation, rows bucket, columns bucket)
+	void write_json(std::ostream& out);
+
+	// Complete ("X") events loadable by chrome://tracing and Perfetto
+	void write_chrome_trace(std::ostream& out);
+} // agla::mtx::instrumentation
+
+#endif // INSTRUMENTATION_HPP
@@ -0,0 +1,244 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include "kernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AGLA_X86_VARIANTS
+#endif
+
+namespace agla::mtx::kernels {
+	namespace {
+
+		// ----------------------- Variants -----------------------
+
+		// The lanes<T> accumulators of the generic code packed into registers of width values:
+		// lane l is element l % width of register l / width, so every lane sees the same
+		// additions in the same order and the final tree is the generic one
+		template <numeric T, std::size_t width> struct packed {
+
+			// Element-aligned and aliasing T, so rows are loaded in place at any offset
+			typedef T vector __attribute__((vector_size(width * sizeof(T)), aligned(sizeof(T)), may_alias));
+			static constexpr std::size_t registers = lanes<T> / width;
+
+			[[gnu::always_inline]] static inline T dot(const T* __restrict__ x, const T* __restrict__ y, const std::size_t size) noexcept {
+				constexpr auto step = lanes<T>;
+				vector acc[registers] = {};
+				std::size_t i = 0;
+
+				for (; i + step <= size; i += step)
+					for (std::size_t r = 0; r < registers; ++r)
+						acc[r] += *reinterpret_cast<const vector*>(x + i + r * width) * *reinterpret_cast<const vector*>(y + i + r * width);
+
+				T lane[step];
+
+				for (std::size_t r = 0; r < registers; ++r)
+					*reinterpret_cast<vector*>(lane + r * width) = acc[r];
+
+				for (; i < size; ++i)
+					lane[0] += x[i] * y[i];
+
+				for (std::size_t half = step / 2; half > 0; half /= 2)
+					for (std::size_t l = 0; l < half; ++l)
+						lane[l] += lane[l + half];
+
+				return lane[0];
+			}
+
+			[[gnu::always_inline]] static inline void axpy(const T alpha, const T* __restrict__ x, T* __restrict__ y, const std::size_t size) noexcept {
+				constexpr auto step = lanes<T>;
+				const vector a = alpha - vector {};
+				std::size_t i = 0;
+
+				for (; i + step <= size; i += step)
+					for (std::size_t r = 0; r < registers; ++r)
+						*reinterpret_cast<vector*>(y + i + r * width) += a * *reinterpret_cast<const vector*>(x + i + r * width);
+
+				for (; i < size; ++i)
+					y[i] += alpha * x[i];
+			}
+
+			// dot2_generic with its sums and errors held in registers; the splitting and summation
+			// steps are spelled out since two_sum and two_product take scalars
+			[[gnu::always_inline]] static inline double_word<T> dot2(const T* __restrict__ x, const T* __restrict__ y, const std::size_t size) noexcept {
+				constexpr auto step = lanes<T>;
+				const vector split = split_factor<T> - vector {};
+				vector sums[registers] = {};
+				vector errors[registers] = {};
+				std::size_t i = 0;
+
+				for (; i + step <= size; i += step) {
+					for (std::size_t r = 0; r < registers; ++r) {
+						const auto a = *reinterpret_cast<const vector*>(x + i + r * width);
+						const auto b = *reinterpret_cast<const vector*>(y + i + r * width);
+
+						const auto product = a * b;
+						const auto a_split = split * a;
+						const auto b_split = split * b;
+						const auto a_hi = a_split - (a_split - a);
+						const auto b_hi = b_split - (b_split - b);
+						const auto a_lo = a - a_hi;
+						const auto b_lo = b - b_hi;
+						const auto product_error = ((a_hi * b_hi - product) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+
+						const auto sum = sums[r] + product;
+						const auto b_virtual = sum - sums[r];
+						const auto sum_error = (sums[r] - (sum - b_virtual)) + (product - b_virtual);
+
+						sums[r] = sum;
+						errors[r] += sum_error + product_error;
+					}
+				}
+
+				T sum_lanes[step];
+				T error_lanes[step];
+
+				for (std::size_t r = 0; r < registers; ++r) {
+					*reinterpret_cast<vector*>(sum_lanes + r * width) = sums[r];
+					*reinterpret_cast<vector*>(error_lanes + r * width) = errors[r];
+				}
+
+				return dot2_finish(sum_lanes, error_lanes, x, y, i, size);
+			}
+		};
+
+		template <numeric T> T dot_portable(const T* x, const T* y, const std::size_t size) noexcept {
+			return dot_generic(x, y, size);
+		}
+
+		template <numeric T> void axpy_portable(const T alpha, const T* x, T* y, const std::size_t size) noexcept {
+			axpy_generic(alpha, x, y, size);
+		}
+
+		template <numeric T> double_word<T> dot2_portable(const T* x, const T* y, const std::size_t size) noexcept {
+			return dot2_generic(x, y, size);
+		}
+
+#ifdef AGLA_X86_VARIANTS
+		template <numeric T> [[gnu::target("sse4.2")]] T dot_sse4_2(const T* x, const T* y, const std::size_t size) noexcept {
+			return packed<T, 16 / sizeof(T)>::dot(x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("sse4.2")]] void axpy_sse4_2(const T alpha, const T* x, T* y, const std::size_t size) noexcept {
+			packed<T, 16 / sizeof(T)>::axpy(alpha, x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("sse4.2")]] double_word<T> dot2_sse4_2(const T* x, const T* y, const std::size_t size) noexcept {
+			return packed<T, 16 / sizeof(T)>::dot2(x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("avx2")]] T dot_avx2(const T* x, const T* y, const std::size_t size) noexcept {
+			return packed<T, 32 / sizeof(T)>::dot(x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("avx2")]] void axpy_avx2(const T alpha, const T* x, T* y, const std::size_t size) noexcept {
+			packed<T, 32 / sizeof(T)>::axpy(alpha, x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("avx2")]] double_word<T> dot2_avx2(const T* x, const T* y, const std::size_t size) noexcept {
+			return packed<T, 32 / sizeof(T)>::dot2(x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("avx512f")]] T dot_avx512(const T* x, const T* y, const std::size_t size) noexcept {
+			return packed<T, 64 / sizeof(T)>::dot(x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("avx512f")]] void axpy_avx512(const T alpha, const T* x, T* y, const std::size_t size) noexcept {
+			packed<T, 64 / sizeof(T)>::axpy(alpha, x, y, size);
+		}
+
+		template <numeric T> [[gnu::target("avx512f")]] double_word<T> dot2_avx512(const T* x, const T* y, const std::size_t size) noexcept {
+			return packed<T, 64 / sizeof(T)>::dot2(x, y, size);
+		}
+#endif
+
+		// Indexed by isa
+		template <numeric T> const kernel_table<T> tables[] = {
+			{ dot_portable<T>, axpy_portable<T>, dot2_portable<T> },
+#ifdef AGLA_X86_VARIANTS
+			{ dot_sse4_2<T>, axpy_sse4_2<T>, dot2_sse4_2<T> },
+			{ dot_avx2<T>, axpy_avx2<T>, dot2_avx2<T> },
+			{ dot_avx512<T>, axpy_avx512<T>, dot2_avx512<T> }
+#endif
+		};
+
+		// ----------------------- Selection -----------------------
+
+		[[nodiscard]] bool supported(const isa target) noexcept {
+			switch (target) {
+				case isa::generic: return true;
+#ifdef AGLA_X86_VARIANTS
+				case isa::sse4_2: return __builtin_cpu_supports("sse4.2");
+				case isa::avx2: return __builtin_cpu_supports("avx2");
+				case isa::avx512: return __builtin_cpu_supports("avx512f");
+#else
+				default: return false;
+#endif
+			}
+
+			return false;
+		}
+
+		[[nodiscard]] isa initial_isa() noexcept {
+			if (const auto* const env = std::getenv("AGLA_ISA")) {
+				for (const auto target : { isa::generic, isa::sse4_2, isa::avx2, isa::avx512 })
+					if (std::strcmp(env, name(target)) == 0 && supported(target))
+						return target;
+			}
+
+			return detected_isa();
+		}
+
+		std::once_flag selection_flag;
+		std::atomic<isa> selected = isa::generic;
+
+		[[nodiscard]] isa selection() noexcept {
+			std::call_once(selection_flag, [] { selected.store(initial_isa(), std::memory_order_relaxed); });
+			return selected.load(std::memory_order_relaxed);
+		}
+	}
+
+	// ----------------------- ISA dispatch -----------------------
+
+	[[nodiscard]] const char* name(const isa target) noexcept {
+		switch (target) {
+			case isa::generic: return "generic";
+			case isa::sse4_2: return "sse4.2";
+			case isa::avx2: return "avx2";
+			case isa::avx512: return "avx512";
+		}
+
+		return "unknown";
+	}
+
+	[[nodiscard]] isa detected_isa() noexcept {
+		for (const auto target : { isa::avx512, isa::avx2, isa::sse4_2 })
+			if (supported(target))
+				return target;
+
+		return isa::generic;
+	}
+
+	[[nodiscard]] isa active_isa() noexcept {
+		return selection();
+	}
+
+	[[nodiscard]] bool force_isa(const isa target) noexcept {
+		static_cast<void>(selection());
+
+		if (!supported(target))
+			return false;
+
+		selected.store(target, std::memory_order_relaxed);
+		return true;
+	}
+
+	template <numeric T> [[nodiscard]] const kernel_table<T>& dispatched() noexcept {
+		return tables<T>[static_cast<std::size_t>(selection())];
+	}
+
+	template const kernel_table<float>& dispatched() noexcept;
+	template const kernel_table<double>& dispatched() noexcept;
+} // agla::mtx::kernels
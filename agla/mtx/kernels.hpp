@@ -0,0 +1,294 @@
+#ifndef KERNELS_HPP
+#define KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "matrix.hpp"
+
+namespace agla::mtx::kernels {
+
+	// Independent accumulators per element width: two AVX registers worth
+	// for float and double, and few enough for long double to stay on the x87 stack
+
+	template <numeric T> constexpr std::size_t lanes = 4;
+	template <> constexpr std::size_t lanes<float> = 16;
+	template <> constexpr std::size_t lanes<double> = 8;
+	template <> constexpr std::size_t lanes<long double> = 2;
+
+	// ----------------------- ISA dispatch -----------------------
+
+	// dot, dot2 and axpy on float and double have variants for each of these, picked once from CPUID.
+	// Every variant keeps the lanes<T> accumulators of the generic code and never contracts into
+	// FMA, so all of them return bit-identical results
+	enum class isa : std::uint8_t {
+		generic,
+		sse4_2,
+		avx2,
+		avx512
+	};
+
+	[[nodiscard]] const char* name(isa target) noexcept;
+
+	// Best variant this CPU and OS support
+	[[nodiscard]] isa detected_isa() noexcept;
+	[[nodiscard]] isa active_isa() noexcept;
+
+	// Pins a variant, e.g. for tests; false if the CPU lacks it. AGLA_ISA=generic|sse4.2|avx2|avx512
+	// does the same at the first kernel call
+	[[nodiscard]] bool force_isa(isa target) noexcept;
+
+	template <numeric T> struct double_word;
+
+	template <numeric T> struct kernel_table {
+		T (*dot)(const T* x, const T* y, std::size_t size) noexcept;
+		void (*axpy)(T alpha, const T* x, T* y, std::size_t size) noexcept;
+		double_word<T> (*dot2)(const T* x, const T* y, std::size_t size) noexcept;
+	};
+
+	// Defined for float and double
+	template <numeric T> [[nodiscard]] const kernel_table<T>& dispatched() noexcept;
+
+	// Shorter vectors stay on the inlined generic code, where an indirect call would cost more
+	// than the wider registers save
+	constexpr std::size_t dispatch_threshold = 32;
+
+	template <numeric T> constexpr bool has_variants = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+	// ----------------------- Vector kernels -----------------------
+
+	template <numeric T> [[nodiscard]] inline T dot_generic(const T* __restrict__ x, const T* __restrict__ y, const std::size_t size) noexcept {
+		constexpr auto width = lanes<T>;
+		T acc[width] = {};
+		std::size_t i = 0;
+
+		for (; i + width <= size; i += width)
+			for (std::size_t l = 0; l < width; ++l)
+				acc[l] += x[i + l] * y[i + l];
+
+		for (; i < size; ++i)
+			acc[0] += x[i] * y[i];
+
+		for (std::size_t step = width / 2; step > 0; step /= 2)
+			for (std::size_t l = 0; l < step; ++l)
+				acc[l] += acc[l + step];
+
+		return acc[0];
+	}
+
+	template <numeric T> inline void axpy_generic(const T alpha, const T* __restrict__ x, T* __restrict__ y, const std::size_t size) noexcept {
+		constexpr auto width = lanes<T>;
+		std::size_t i = 0;
+
+		for (; i + width <= size; i += width)
+			for (std::size_t l = 0; l < width; ++l)
+				y[i + l] += alpha * x[i + l];
+
+		for (; i < size; ++i)
+			y[i] += alpha * x[i];
+	}
+
+	template <numeric T> [[nodiscard]] inline T dot(const T* __restrict__ x, const T* __restrict__ y, const std::size_t size) noexcept {
+		if constexpr (has_variants<T>)
+			if (size >= dispatch_threshold)
+				return dispatched<T>().dot(x, y, size);
+
+		return dot_generic(x, y, size);
+	}
+
+	template <numeric T> [[nodiscard]] inline T sum_of_squares(const T* __restrict__ x, const std::size_t size) noexcept {
+		return dot(x, x, size);
+	}
+
+	template <numeric T> inline void axpy(const T alpha, const T* __restrict__ x, T* __restrict__ y, const std::size_t size) noexcept {
+		if constexpr (has_variants<T>) {
+			if (size >= dispatch_threshold) {
+				dispatched<T>().axpy(alpha, x, y, size);
+				return;
+			}
+		}
+
+		axpy_generic(alpha, x, y, size);
+	}
+
+	// ----------------------- Compensated kernels -----------------------
+
+	// Unevaluated sum hi + lo of a value carried in twice the working precision
+	template <numeric T> struct double_word {
+		T hi;
+		T lo;
+
+		[[nodiscard]] inline T value() const noexcept { return hi + lo; }
+	};
+
+	// Veltkamp's splitting constant 2^ceil(digits / 2) + 1
+	template <numeric T> constexpr T split_factor = T((1ull << ((std::numeric_limits<T>::digits + 1) / 2)) + 1);
+
+	// Error-free transformations: a + b and a * b exactly as hi + lo. two_product splits its
+	// factors, so they must stay below max / split_factor
+	template <numeric T> [[nodiscard]] inline double_word<T> two_sum(const T a, const T b) noexcept {
+		const auto sum = a + b;
+		const auto b_virtual = sum - a;
+
+		return { sum, (a - (sum - b_virtual)) + (b - b_virtual) };
+	}
+
+	template <numeric T> [[nodiscard]] inline double_word<T> two_product(const T a, const T b) noexcept {
+		const auto product = a * b;
+		const auto a_split = split_factor<T> * a;
+		const auto b_split = split_factor<T> * b;
+		const auto a_hi = a_split - (a_split - a);
+		const auto b_hi = b_split - (b_split - b);
+		const auto a_lo = a - a_hi;
+		const auto b_lo = b - b_hi;
+
+		return { product, ((a_hi * b_hi - product) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo };
+	}
+
+	// Lanes [0, lanes<T>) of sums and corrections, folded with the tail [i, size) into one
+	// double word; shared by every dot2 variant so they agree to the bit
+	template <numeric T> [[nodiscard]] inline double_word<T> dot2_finish(T* const sums, T* const errors, const T* x, const T* y, std::size_t i, const std::size_t size) noexcept {
+		for (; i < size; ++i) {
+			const auto product = two_product(x[i], y[i]);
+			const auto sum = two_sum(sums[0], product.hi);
+			sums[0] = sum.hi;
+			errors[0] += sum.lo + product.lo;
+		}
+
+		for (std::size_t step = lanes<T> / 2; step > 0; step /= 2) {
+			for (std::size_t l = 0; l < step; ++l) {
+				const auto sum = two_sum(sums[l], sums[l + step]);
+				sums[l] = sum.hi;
+				errors[l] += errors[l + step] + sum.lo;
+			}
+		}
+
+		return two_sum(sums[0], errors[0]);
+	}
+
+	// Ogita, Rump and Oishi's Dot2: as accurate as dot evaluated in twice the working
+	// precision, at a few times its cost
+	template <numeric T> [[nodiscard]] inline double_word<T> dot2_generic(const T* __restrict__ x, const T* __restrict__ y, const std::size_t size) noexcept {
+		constexpr auto width = lanes<T>;
+		T sums[width] = {};
+		T errors[width] = {};
+		std::size_t i = 0;
+
+		for (; i + width <= size; i += width) {
+			for (std::size_t l = 0; l < width; ++l) {
+				const auto product = two_product(x[i + l], y[i + l]);
+				const auto sum = two_sum(sums[l], product.hi);
+				sums[l] = sum.hi;
+				errors[l] += sum.lo + product.lo;
+			}
+		}
+
+		return dot2_finish(sums, errors, x, y, i, size);
+	}
+
+	template <numeric T> [[nodiscard]] inline double_word<T> dot2(const T* __restrict__ x, const T* __restrict__ y, const std::size_t size) noexcept {
+		if constexpr (has_variants<T>)
+			if (size >= dispatch_threshold)
+				return dispatched<T>().dot2(x, y, size);
+
+		return dot2_generic(x, y, size);
+	}
+
+	template <numeric T> inline void scal(const T alpha, T* __restrict__ x, const std::size_t size) noexcept {
+		for (std::size_t i = 0; i < size; ++i)
+			x[i] *= alpha;
+	}
+
+	// Transposes take arrays of row pointers, since rows live in separate allocations.
+	// Halving the longer side until a tile fits in L1 keeps both the reads and the writes
+	// cache friendly without tuning for a particular cache size
+
+	constexpr std::size_t transpose_tile = 16;
+
+	template <numeric T> inline void transpose(
+		const T* const* const src,
+		T* const* const dst,
+		const std::size_t row_begin,
+		const std::size_t row_end,
+		const std::size_t column_begin,
+		const std::size_t column_end
+	) noexcept {
+		const auto rows = row_end - row_begin;
+		const auto columns = column_end - column_begin;
+
+		if (rows <= transpose_tile && columns <= transpose_tile) {
+			for (std::size_t q = column_begin; q < column_end; ++q) {
+				auto* const out = dst[q];
+
+				for (std::size_t i = row_begin; i < row_end; ++i)
+					out[i] = src[i][q];
+			}
+
+			return;
+		}
+
+		if (rows >= columns) {
+			const auto middle = row_begin + rows / 2;
+			transpose(src, dst, row_begin, middle, column_begin, column_end);
+			transpose(src, dst, middle, row_end, column_begin, column_end);
+		} else {
+			const auto middle = column_begin + columns / 2;
+			transpose(src, dst, row_begin, row_end, column_begin, middle);
+			transpose(src, dst, row_begin, row_end, middle, column_end);
+		}
+	}
+
+	// Swaps the block [row_begin, row_end) x [column_begin, column_end) with its mirror
+	// across the diagonal; the two blocks must not overlap
+	template <numeric T> inline void swap_transposed(
+		T* const* const rows,
+		const std::size_t row_begin,
+		const std::size_t row_end,
+		const std::size_t column_begin,
+		const std::size_t column_end
+	) noexcept {
+		const auto height = row_end - row_begin;
+		const auto width = column_end - column_begin;
+
+		if (height <= transpose_tile && width <= transpose_tile) {
+			for (std::size_t q = column_begin; q < column_end; ++q) {
+				auto* const mirror = rows[q];
+
+				for (std::size_t i = row_begin; i < row_end; ++i)
+					std::swap(mirror[i], rows[i][q]);
+			}
+
+			return;
+		}
+
+		if (height >= width) {
+			const auto middle = row_begin + height / 2;
+			swap_transposed(rows, row_begin, middle, column_begin, column_end);
+			swap_transposed(rows, middle, row_end, column_begin, column_end);
+		} else {
+			const auto middle = column_begin + width / 2;
+			swap_transposed(rows, row_begin, row_end, column_begin, middle);
+			swap_transposed(rows, row_begin, row_end, middle, column_end);
+		}
+	}
+
+	template <numeric T> inline void transpose_in_place(T* const* const rows, const std::size_t begin, const std::size_t end) noexcept {
+		if (end - begin <= transpose_tile) {
+			for (std::size_t i = begin; i < end; ++i)
+				for (std::size_t q = i + 1; q < end; ++q)
+					std::swap(rows[i][q], rows[q][i]);
+
+			return;
+		}
+
+		const auto middle = begin + (end - begin) / 2;
+		transpose_in_place(rows, begin, middle);
+		transpose_in_place(rows, middle, end);
+		swap_transposed(rows, begin, middle, middle, end);
+	}
+} // agla::mtx::kernels
+
+#endif // KERNELS_HPP
@@ -0,0 +1,347 @@
+#include <cmath>
+#include <limits>
+
+#include "lu_decomposition.hpp"
+#include "kernels.hpp"
+#include "norm_estimate.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::mtx {
+
+	// ----------------------- Constructors -----------------------
+
+	template <numeric T> lu_decomposition<T>::lu_decomposition(
+		square_matrix<T>&& lu,
+		std::vector<std::size_t>&& row_pivots
+	) noexcept : lu(std::move(lu)), row_pivots(std::move(row_pivots)) {}
+
+	template <numeric T> [[nodiscard]] std::optional<lu_decomposition<T>> lu_decomposition<T>::from_square_matrix(const square_matrix<T>& mtx) noexcept {
+		auto copy = mtx;
+		return from_square_matrix(std::move(copy));
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<lu_decomposition<T>> lu_decomposition<T>::from_square_matrix(square_matrix<T>&& mtx) noexcept {
+		std::vector<std::size_t> pivots;
+
+		if (!factorize_in_place(mtx, pivots))
+			return std::nullopt;
+
+		return std::make_optional(lu_decomposition(std::move(mtx), std::move(pivots)));
+	}
+
+	// ----------------------- In-place kernels -----------------------
+
+	template <numeric T> [[nodiscard]] bool lu_decomposition<T>::factorize_in_place(square_matrix<T>& mtx, std::vector<std::size_t>& pivots) noexcept {
+		constexpr std::size_t block = 64;
+
+		const auto size = mtx.size();
+		auto& pool = par::thread_pool::instance();
+		pivots.resize(size);
+
+		AGLA_INSTRUMENT(lu_factorize, size, size, 2 * size * size * size / 3, 2 * size * size * sizeof(T));
+
+		for (std::size_t panel = 0; panel < size; panel += block) {
+			const auto panel_end = std::min(panel + block, size);
+
+			// Unblocked factorization of the panel columns; rows are swapped whole,
+			// which also applies the interchanges to L and to the trailing columns
+
+			for (std::size_t k = panel; k < panel_end; ++k) {
+				auto pivot = k;
+
+				for (std::size_t i = k + 1; i < size; ++i)
+					if (std::abs(mtx.get_unchecked(i).get_unchecked(k)) > std::abs(mtx.get_unchecked(pivot).get_unchecked(k)))
+						pivot = i;
+
+				pivots[k] = pivot;
+
+				if (mtx.get_unchecked(pivot).get_unchecked(k) == 0)
+					return false;
+
+				if (pivot != k)
+					std::swap(mtx.get_unchecked(k), mtx.get_unchecked(pivot));
+
+				const auto* const row_k = mtx.get_unchecked(k).data();
+				const auto inv_diag = 1 / row_k[k];
+
+				pool.parallel_for(k + 1, size, par::thread_pool::grain_for(panel_end - k), [&](const std::size_t from, const std::size_t to) {
+					for (std::size_t i = from; i < to; ++i) {
+						auto* const row_i = mtx.get_unchecked(i).data();
+						row_i[k] *= inv_diag;
+						kernels::axpy(-row_i[k], row_k + k + 1, row_i + k + 1, panel_end - k - 1);
+					}
+				});
+			}
+
+			if (panel_end == size)
+				break;
+
+			const auto rest = size - panel_end;
+
+			// U12 = L11^-1 * A12, split across column panels
+
+			pool.parallel_for(panel_end, size, par::thread_pool::grain_for(block * block), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t k = panel; k < panel_end; ++k) {
+					const auto* const row_k = mtx.get_unchecked(k).data();
+
+					for (std::size_t i = k + 1; i < panel_end; ++i) {
+						auto* const row_i = mtx.get_unchecked(i).data();
+						kernels::axpy(-row_i[k], row_k + from, row_i + from, to - from);
+					}
+				}
+			});
+
+			// A22 -= L21 * U12
+
+			pool.parallel_for(panel_end, size, par::thread_pool::grain_for(block * rest), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t i = from; i < to; ++i) {
+					auto* const row_i = mtx.get_unchecked(i).data();
+
+					for (std::size_t k = panel; k < panel_end; ++k)
+						kernels::axpy(-row_i[k], mtx.get_unchecked(k).data() + panel_end, row_i + panel_end, rest);
+				}
+			});
+		}
+
+		return true;
+	}
+
+	template <numeric T> void lu_decomposition<T>::invert_in_place(square_matrix<T>& lu, const std::vector<std::size_t>& pivots) noexcept {
+		const auto size = lu.size();
+
+		AGLA_INSTRUMENT(lu_invert, size, size, 4 * size * size * size / 3, 2 * size * size * sizeof(T));
+
+		auto& pool = par::thread_pool::instance();
+		std::vector<T> work(size);
+
+		// U^-1 row by row from the bottom, each row accumulated across column panels
+
+		for (std::size_t i = size; i-- > 0;) {
+			auto* const row_i = lu.get_unchecked(i).data();
+			const auto inv_diag = 1 / row_i[i];
+
+			pool.parallel_for(i + 1, size, par::thread_pool::grain_for(size - i), [&](const std::size_t from, const std::size_t to) {
+				std::fill(work.begin() + from, work.begin() + to, T(0));
+
+				for (std::size_t k = i + 1; k < to; ++k) {
+					const auto start = std::max(k, from);
+					kernels::axpy(row_i[k], lu.get_unchecked(k).data() + start, work.data() + start, to - start);
+				}
+			});
+
+			row_i[i] = inv_diag;
+
+			for (std::size_t q = i + 1; q < size; ++q)
+				row_i[q] = -work[q] * inv_diag;
+		}
+
+		// Solve A^-1 * L = U^-1 one column at a time
+
+		for (std::size_t j = size - 1; j-- > 0;) {
+			for (std::size_t i = j + 1; i < size; ++i) {
+				auto& elem = lu.get_unchecked(i).get_unchecked(j);
+				work[i] = elem;
+				elem = 0;
+			}
+
+			pool.parallel_for(0, size, par::thread_pool::grain_for(size - j), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t r = from; r < to; ++r) {
+					auto* const row = lu.get_unchecked(r).data();
+					row[j] -= kernels::dot(row + j + 1, work.data() + j + 1, size - j - 1);
+				}
+			});
+		}
+
+		// Undo the row interchanges as column interchanges
+
+		pool.parallel_for(0, size, par::thread_pool::grain_for(size), [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t r = from; r < to; ++r) {
+				auto* const row = lu.get_unchecked(r).data();
+
+				for (std::size_t j = size; j-- > 0;)
+					if (pivots[j] != j)
+						std::swap(row[j], row[pivots[j]]);
+			}
+		});
+	}
+
+	template <numeric T> [[nodiscard]] signed_log_determinant<T> lu_decomposition<T>::log_abs_determinant(
+		const square_matrix<T>& lu,
+		const std::vector<std::size_t>& pivots
+	) noexcept {
+		signed_log_determinant<T> result { T(1), T(0) };
+
+		for (std::size_t i = 0; i < lu.size(); ++i) {
+			const auto diag = lu.get_unchecked(i).get_unchecked(i);
+
+			if (diag == 0)
+				return { T(0), -std::numeric_limits<T>::infinity() };
+
+			if ((diag < 0) != (pivots[i] != i))
+				result.sign = -result.sign;
+
+			result.log_abs_value += std::log(std::abs(diag));
+		}
+
+		return result;
+	}
+
+	// ----------------------- Accessors -----------------------
+
+	template <numeric T> [[nodiscard]] inline std::size_t lu_decomposition<T>::size() const noexcept {
+		return lu.size();
+	}
+
+	template <numeric T> [[nodiscard]] inline const square_matrix<T>& lu_decomposition<T>::factors() const noexcept {
+		return lu;
+	}
+
+	template <numeric T> [[nodiscard]] inline const std::vector<std::size_t>& lu_decomposition<T>::pivots() const noexcept {
+		return row_pivots;
+	}
+
+	// ----------------------- Operations -----------------------
+
+	template <numeric T> [[nodiscard]] inline column_vector<T> lu_decomposition<T>::solve_unchecked(const column_vector<T>& b) const noexcept {
+		const auto sz = size();
+		std::vector<T> buf(sz);
+
+		for (std::size_t i = 0; i < sz; ++i)
+			buf[i] = b.get_unchecked(i);
+
+		solve_in_place(buf.data());
+
+		column_vector<T> result(sz);
+
+		for (std::size_t i = 0; i < sz; ++i)
+			result.get_unchecked(i) = buf[i];
+
+		return result;
+	}
+
+	template <numeric T> inline void lu_decomposition<T>::solve_in_place(T* const b) const noexcept {
+		const auto sz = size();
+
+		for (std::size_t i = 0; i < sz; ++i)
+			std::swap(b[i], b[row_pivots[i]]);
+
+		for (std::size_t i = 0; i < sz; ++i)
+			b[i] -= kernels::dot(lu.get_unchecked(i).data(), b, i);
+
+		for (std::size_t i = sz; i-- > 0;) {
+			const auto* const row_i = lu.get_unchecked(i).data();
+			b[i] = (b[i] - kernels::dot(row_i + i + 1, b + i + 1, sz - i - 1)) / row_i[i];
+		}
+	}
+
+	template <numeric T> inline void lu_decomposition<T>::solve_transposed_in_place(T* const b) const noexcept {
+		const auto sz = size();
+
+		// A^T = U^T * L^T * P, both triangles walked by rows
+
+		for (std::size_t i = 0; i < sz; ++i) {
+			const auto* const row_i = lu.get_unchecked(i).data();
+			b[i] /= row_i[i];
+			kernels::axpy(-b[i], row_i + i + 1, b + i + 1, sz - i - 1);
+		}
+
+		for (std::size_t i = sz; i-- > 0;)
+			kernels::axpy(-b[i], lu.get_unchecked(i).data(), b, i);
+
+		for (std::size_t i = sz; i-- > 0;)
+			std::swap(b[i], b[row_pivots[i]]);
+	}
+
+	template <numeric T> [[nodiscard]] inline T lu_decomposition<T>::determinant() const noexcept {
+		T acc = 1;
+
+		for (std::size_t i = 0; i < size(); ++i) {
+			acc *= lu.get_unchecked(i).get_unchecked(i);
+
+			if (row_pivots[i] != i)
+				acc = -acc;
+		}
+
+		return acc;
+	}
+
+	template <numeric T> [[nodiscard]] inline signed_log_determinant<T> lu_decomposition<T>::log_abs_determinant() const noexcept {
+		return log_abs_determinant(lu, row_pivots);
+	}
+
+	template <numeric T> [[nodiscard]] inline T lu_decomposition<T>::condition_estimate(const T one_norm) const noexcept {
+		return one_norm * inverse_one_norm_estimate<T>(
+			size(),
+			[this](T* const x) { solve_in_place(x); },
+			[this](T* const x) { solve_transposed_in_place(x); }
+		);
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	template lu_decomposition<double>::lu_decomposition(square_matrix<double>&& lu, std::vector<std::size_t>&& row_pivots) noexcept;
+	template std::optional<lu_decomposition<double>> lu_decomposition<double>::from_square_matrix(const square_matrix<double>& mtx) noexcept;
+	template std::optional<lu_decomposition<double>> lu_decomposition<double>::from_square_matrix(square_matrix<double>&& mtx) noexcept;
+
+	template lu_decomposition<float>::lu_decomposition(square_matrix<float>&& lu, std::vector<std::size_t>&& row_pivots) noexcept;
+	template std::optional<lu_decomposition<float>> lu_decomposition<float>::from_square_matrix(const square_matrix<float>& mtx) noexcept;
+	template std::optional<lu_decomposition<float>> lu_decomposition<float>::from_square_matrix(square_matrix<float>&& mtx) noexcept;
+
+	template lu_decomposition<long double>::lu_decomposition(square_matrix<long double>&& lu, std::vector<std::size_t>&& row_pivots) noexcept;
+	template std::optional<lu_decomposition<long double>> lu_decomposition<long double>::from_square_matrix(const square_matrix<long double>& mtx) noexcept;
+	template std::optional<lu_decomposition<long double>> lu_decomposition<long double>::from_square_matrix(square_matrix<long double>&& mtx) noexcept;
+
+	// ----------------------- In-place kernels -----------------------
+
+	template bool lu_decomposition<double>::factorize_in_place(square_matrix<double>& mtx, std::vector<std::size_t>& pivots) noexcept;
+	template void lu_decomposition<double>::invert_in_place(square_matrix<double>& lu, const std::vector<std::size_t>& pivots) noexcept;
+	template signed_log_determinant<double> lu_decomposition<double>::log_abs_determinant(const square_matrix<double>& lu, const std::vector<std::size_t>& pivots) noexcept;
+
+	template bool lu_decomposition<float>::factorize_in_place(square_matrix<float>& mtx, std::vector<std::size_t>& pivots) noexcept;
+	template void lu_decomposition<float>::invert_in_place(square_matrix<float>& lu, const std::vector<std::size_t>& pivots) noexcept;
+	template signed_log_determinant<float> lu_decomposition<float>::log_abs_determinant(const square_matrix<float>& lu, const std::vector<std::size_t>& pivots) noexcept;
+
+	template bool lu_decomposition<long double>::factorize_in_place(square_matrix<long double>& mtx, std::vector<std::size_t>& pivots) noexcept;
+	template void lu_decomposition<long double>::invert_in_place(square_matrix<long double>& lu, const std::vector<std::size_t>& pivots) noexcept;
+	template signed_log_determinant<long double> lu_decomposition<long double>::log_abs_determinant(const square_matrix<long double>& lu, const std::vector<std::size_t>& pivots) noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t lu_decomposition<double>::size() const noexcept;
+	template const square_matrix<double>& lu_decomposition<double>::factors() const noexcept;
+	template const std::vector<std::size_t>& lu_decomposition<double>::pivots() const noexcept;
+
+	template std::size_t lu_decomposition<float>::size() const noexcept;
+	template const square_matrix<float>& lu_decomposition<float>::factors() const noexcept;
+	template const std::vector<std::size_t>& lu_decomposition<float>::pivots() const noexcept;
+
+	template std::size_t lu_decomposition<long double>::size() const noexcept;
+	template const square_matrix<long double>& lu_decomposition<long double>::factors() const noexcept;
+	template const std::vector<std::size_t>& lu_decomposition<long double>::pivots() const noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template column_vector<double> lu_decomposition<double>::solve_unchecked(const column_vector<double>& b) const noexcept;
+	template void lu_decomposition<double>::solve_in_place(double* b) const noexcept;
+	template void lu_decomposition<double>::solve_transposed_in_place(double* b) const noexcept;
+
+	template double lu_decomposition<double>::determinant() const noexcept;
+	template signed_log_determinant<double> lu_decomposition<double>::log_abs_determinant() const noexcept;
+	template double lu_decomposition<double>::condition_estimate(double one_norm) const noexcept;
+
+	template column_vector<float> lu_decomposition<float>::solve_unchecked(const column_vector<float>& b) const noexcept;
+	template void lu_decomposition<float>::solve_in_place(float* b) const noexcept;
+	template void lu_decomposition<float>::solve_transposed_in_place(float* b) const noexcept;
+
+	template float lu_decomposition<float>::determinant() const noexcept;
+	template signed_log_determinant<float> lu_decomposition<float>::log_abs_determinant() const noexcept;
+	template float lu_decomposition<float>::condition_estimate(float one_norm) const noexcept;
+
+	template column_vector<long double> lu_decomposition<long double>::solve_unchecked(const column_vector<long double>& b) const noexcept;
+	template void lu_decomposition<long double>::solve_in_place(long double* b) const noexcept;
+	template void lu_decomposition<long double>::solve_transposed_in_place(long double* b) const noexcept;
+
+	template long double lu_decomposition<long double>::determinant() const noexcept;
+	template signed_log_determinant<long double> lu_decomposition<long double>::log_abs_determinant() const noexcept;
+	template long double lu_decomposition<long double>::condition_estimate(long double one_norm) const noexcept;
+} // agla::mtx
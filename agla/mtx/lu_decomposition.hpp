@@ -0,0 +1,52 @@
+#ifndef LU_DECOMPOSITION_HPP
+#define LU_DECOMPOSITION_HPP
+
+#include "column_vector.hpp"
+
+namespace agla::mtx {
+	template <numeric T> class lu_decomposition {
+		square_matrix<T> lu;
+		std::vector<std::size_t> row_pivots;
+
+		lu_decomposition(square_matrix<T>&& lu, std::vector<std::size_t>&& row_pivots) noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		[[nodiscard]] static std::optional<lu_decomposition> from_square_matrix(const square_matrix<T>& mtx) noexcept;
+		[[nodiscard]] static std::optional<lu_decomposition> from_square_matrix(square_matrix<T>&& mtx) noexcept;
+
+		// ----------------------- In-place kernels -----------------------
+
+		// Blocked P*A = L*U with unit L below and U on/above the diagonal of mtx;
+		// pivots[k] is the row swapped with row k. Returns false on an exact zero pivot
+		[[nodiscard]] static bool factorize_in_place(square_matrix<T>& mtx, std::vector<std::size_t>& pivots) noexcept;
+
+		// Overwrites the factors with A^-1 using O(n) extra memory
+		static void invert_in_place(square_matrix<T>& lu, const std::vector<std::size_t>& pivots) noexcept;
+
+		// Sums log|u_ii| instead of multiplying the diagonal, so it neither overflows nor underflows
+		[[nodiscard]] static signed_log_determinant<T> log_abs_determinant(const square_matrix<T>& lu, const std::vector<std::size_t>& pivots) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t size() const noexcept;
+		[[nodiscard]] inline const square_matrix<T>& factors() const noexcept;
+		[[nodiscard]] inline const std::vector<std::size_t>& pivots() const noexcept;
+
+		// ----------------------- Operations -----------------------
+
+		[[nodiscard]] inline column_vector<T> solve_unchecked(const column_vector<T>& b) const noexcept;
+		inline void solve_in_place(T* b) const noexcept;
+		inline void solve_transposed_in_place(T* b) const noexcept;
+
+		[[nodiscard]] inline T determinant() const noexcept;
+		[[nodiscard]] inline signed_log_determinant<T> log_abs_determinant() const noexcept;
+
+		// Estimated kappa_1(A) = ||A||_1 * ||A^-1||_1, given ||A||_1 of the factorized matrix
+		[[nodiscard]] inline T condition_estimate(T one_norm) const noexcept;
+	};
+} // agla::mtx
+
+#endif // LU_DECOMPOSITION_HPP
@@ -3,6 +3,9 @@
 #include <numeric>
 
 #include "square_matrix.hpp"
+#include "aligned_resource.hpp"
+#include "kernels.hpp"
+#include "../par/thread_pool.hpp"
 
 namespace agla::mtx {
 
@@ -11,11 +14,13 @@ namespace agla::mtx {
 	// ----------------------- Constructors -----------------------
 
 	template <numeric T> matrix<T>::matrix_row::matrix_row() noexcept = default;
-	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::size_t size) noexcept : row(std::vector<T>(size)) {}
-	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::size_t size, const T& elem) noexcept : row(std::vector<T>(size, elem)) {}
-	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::size_t size, T&& elem) noexcept : row(std::vector<T>(size, elem)) {}
-	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::vector<T>& row) noexcept : row(row) {}
-	template <numeric T> matrix<T>::matrix_row::matrix_row(std::vector<T>&& row) noexcept : row(row) {}
+	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::size_t size, const allocator_type& allocator) noexcept : row(size, allocator) {}
+	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::size_t size, const T& elem, const allocator_type& allocator) noexcept : row(size, elem, allocator) {}
+	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::size_t size, T&& elem, const allocator_type& allocator) noexcept : row(size, elem, allocator) {}
+	template <numeric T> matrix<T>::matrix_row::matrix_row(const std::vector<T>& row, const allocator_type& allocator) noexcept : row(row.begin(), row.end(), allocator) {}
+	template <numeric T> matrix<T>::matrix_row::matrix_row(std::vector<T>&& row, const allocator_type& allocator) noexcept : row(row.begin(), row.end(), allocator) {}
+	template <numeric T> matrix<T>::matrix_row::matrix_row(const matrix_row& other, const allocator_type& allocator) noexcept : row(other.row, allocator) {}
+	template <numeric T> matrix<T>::matrix_row::matrix_row(matrix_row&& other, const allocator_type& allocator) noexcept : row(std::move(other.row), allocator) {}
 
 	// ----------------------- Accessors -----------------------
 
@@ -37,7 +42,7 @@ namespace agla::mtx {
 		if (sz != other.size())
 			return std::nullopt;
 
-		matrix_row result(sz);
+		matrix_row result(sz, get_allocator());
 
 		for (std::size_t i = 0; i < sz; ++i)
 			result.get_unchecked(i) = get_unchecked(i) + other.get_unchecked(i);
@@ -51,7 +56,7 @@ namespace agla::mtx {
 		if (sz != other.size())
 			return std::nullopt;
 
-		matrix_row result(sz);
+		matrix_row result(sz, get_allocator());
 
 		for (std::size_t i = 0; i < sz; ++i)
 			result.get_unchecked(i) = get_unchecked(i) - other.get_unchecked(i);
@@ -61,12 +66,13 @@ namespace agla::mtx {
 
 	// ----------------------- Constructors -----------------------
 
-	template matrix<double>::matrix_row::matrix_row() noexcept;
-	template matrix<double>::matrix_row::matrix_row(std::size_t size) noexcept;
-	template matrix<double>::matrix_row::matrix_row(std::size_t size, const double& elem) noexcept;
-	template matrix<double>::matrix_row::matrix_row(std::size_t size, double&& elem) noexcept;
-	template matrix<double>::matrix_row::matrix_row(const std::vector<double>& row) noexcept;
-	template matrix<double>::matrix_row::matrix_row(std::vector<double>&& row) noexcept;
+	template matrix<double>::matrix_row::matrix_row(std::size_t size, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix_row::matrix_row(std::size_t size, const double& elem, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix_row::matrix_row(std::size_t size, double&& elem, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix_row::matrix_row(const std::vector<double>& row, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix_row::matrix_row(std::vector<double>&& row, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix_row::matrix_row(const matrix_row& other, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix_row::matrix_row(matrix_row&& other, const allocator_type& allocator) noexcept;
 
 	// ----------------------- Accessors -----------------------
 
@@ -80,6 +86,50 @@ namespace agla::mtx {
 	template std::optional<matrix<double>::matrix_row> matrix<double>::matrix_row::operator+(const matrix_row& other) const noexcept;
 	template std::optional<matrix<double>::matrix_row> matrix<double>::matrix_row::operator-(const matrix_row& other) const noexcept;
 
+	// ----------------------- Constructors -----------------------
+
+	template matrix<float>::matrix_row::matrix_row(std::size_t size, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix_row::matrix_row(std::size_t size, const float& elem, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix_row::matrix_row(std::size_t size, float&& elem, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix_row::matrix_row(const std::vector<float>& row, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix_row::matrix_row(std::vector<float>&& row, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix_row::matrix_row(const matrix_row& other, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix_row::matrix_row(matrix_row&& other, const allocator_type& allocator) noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t matrix<float>::matrix_row::size() const noexcept;
+	template float& matrix<float>::matrix_row::get_unchecked(std::size_t index) noexcept;
+	template const float& matrix<float>::matrix_row::get_unchecked(std::size_t index) const noexcept;
+	template std::optional<std::reference_wrapper<float>> matrix<float>::matrix_row::operator[](std::size_t index) noexcept;
+
+	// ----------------------- Operators -----------------------
+
+	template std::optional<matrix<float>::matrix_row> matrix<float>::matrix_row::operator+(const matrix_row& other) const noexcept;
+	template std::optional<matrix<float>::matrix_row> matrix<float>::matrix_row::operator-(const matrix_row& other) const noexcept;
+
+	// ----------------------- Constructors -----------------------
+
+	template matrix<long double>::matrix_row::matrix_row(std::size_t size, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix_row::matrix_row(std::size_t size, const long double& elem, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix_row::matrix_row(std::size_t size, long double&& elem, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix_row::matrix_row(const std::vector<long double>& row, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix_row::matrix_row(std::vector<long double>&& row, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix_row::matrix_row(const matrix_row& other, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix_row::matrix_row(matrix_row&& other, const allocator_type& allocator) noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t matrix<long double>::matrix_row::size() const noexcept;
+	template long double& matrix<long double>::matrix_row::get_unchecked(std::size_t index) noexcept;
+	template const long double& matrix<long double>::matrix_row::get_unchecked(std::size_t index) const noexcept;
+	template std::optional<std::reference_wrapper<long double>> matrix<long double>::matrix_row::operator[](std::size_t index) noexcept;
+
+	// ----------------------- Operators -----------------------
+
+	template std::optional<matrix<long double>::matrix_row> matrix<long double>::matrix_row::operator+(const matrix_row& other) const noexcept;
+	template std::optional<matrix<long double>::matrix_row> matrix<long double>::matrix_row::operator-(const matrix_row& other) const noexcept;
+
 	// ########################## Matrix ##########################
 
 	// ----------------------- Iterators -----------------------
@@ -97,21 +147,41 @@ namespace agla::mtx {
 
 	// ----------------------- Constructors -----------------------
 
-	template <numeric T> matrix<T>::matrix(const std::size_t size) noexcept : mtx(std::vector<matrix_row>(size, matrix_row(size))) {}
-	template <numeric T> matrix<T>::matrix(const std::size_t rows, const std::size_t columns) noexcept : mtx(std::vector<matrix_row>(rows, matrix_row(columns))) {}
-	template <numeric T> matrix<T>::matrix(const std::size_t rows, const std::vector<T>& row) noexcept : mtx(std::vector<matrix_row>(rows, matrix_row(row))) {}
-	template <numeric T> matrix<T>::matrix(const std::size_t rows, std::vector<T>&& row) noexcept : mtx(std::vector<matrix_row>(rows, matrix_row(row))) {}
+	template <numeric T> matrix<T>::matrix(const std::size_t size, const allocator_type& allocator) noexcept : matrix(size, size, allocator) {}
+
+	template <numeric T> matrix<T>::matrix(const std::size_t rows, const std::size_t columns, const allocator_type& allocator) noexcept : mtx(allocator) {
+		mtx.reserve(rows);
+
+		for (std::size_t i = 0; i < rows; ++i)
+			mtx.emplace_back(columns);
+	}
+
+	template <numeric T> matrix<T>::matrix(const std::size_t rows, const std::vector<T>& row, const allocator_type& allocator) noexcept : mtx(allocator) {
+		mtx.reserve(rows);
+
+		for (std::size_t i = 0; i < rows; ++i)
+			mtx.emplace_back(row);
+	}
+
+	template <numeric T> matrix<T>::matrix(const std::size_t rows, std::vector<T>&& row, const allocator_type& allocator) noexcept : matrix(rows, row, allocator) {}
+
+	template <numeric T> matrix<T>::matrix(const std::vector<std::vector<T>>& matrix, const allocator_type& allocator) noexcept : mtx(allocator) {
+		mtx.reserve(matrix.size());
 
-	template <numeric T> matrix<T>::matrix(const std::vector<std::vector<T>>& matrix) noexcept {
 		for (const auto& row : matrix)
 			mtx.emplace_back(row);
 	}
 
-	template <numeric T> matrix<T>::matrix(std::vector<std::vector<T>>&& matrix) noexcept {
+	template <numeric T> matrix<T>::matrix(std::vector<std::vector<T>>&& matrix, const allocator_type& allocator) noexcept : mtx(allocator) {
+		mtx.reserve(matrix.size());
+
 		for (auto&& row : matrix)
 			mtx.emplace_back(row);
 	}
 
+	template <numeric T> matrix<T>::matrix(const matrix& other) noexcept : mtx(other.mtx, other.get_allocator()) {}
+	template <numeric T> matrix<T>::matrix(const matrix& other, const allocator_type& allocator) noexcept : mtx(other.mtx, allocator) {}
+
 	template <numeric T> matrix<T>::~matrix() noexcept = default;
 
 	// ----------------------- Accessors -----------------------
@@ -138,15 +208,20 @@ namespace agla::mtx {
 		const auto rows = rows_number();
 		const auto columns = columns_number();
 
-		matrix result(rows, columns);
+		AGLA_INSTRUMENT(add, rows, columns, rows * columns, 3 * rows * columns * sizeof(T));
 
-		auto this_it = begin();
-		auto other_it = other.begin();
+		matrix result(rows, columns, get_allocator());
 
-		for (auto& elem : result) {
-			elem = *this_it + *other_it;
-			++this_it, ++other_it;
-		}
+		par::thread_pool::instance().parallel_for(0, rows, par::thread_pool::grain_for(columns), [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t i = from; i < to; ++i) {
+				const auto* const this_row = get_unchecked(i).data();
+				const auto* const other_row = other.get_unchecked(i).data();
+				auto* const result_row = result.get_unchecked(i).data();
+
+				for (std::size_t q = 0; q < columns; ++q)
+					result_row[q] = this_row[q] + other_row[q];
+			}
+		});
 
 		return std::move(result);
 	}
@@ -155,86 +230,98 @@ namespace agla::mtx {
 		const auto rows = rows_number();
 		const auto columns = columns_number();
 
-		matrix result(rows, columns);
+		AGLA_INSTRUMENT(sub, rows, columns, rows * columns, 3 * rows * columns * sizeof(T));
 
-		auto this_it = begin();
-		auto other_it = other.begin();
+		matrix result(rows, columns, get_allocator());
 
-		for (auto& elem : result) {
-			elem = *this_it - *other_it;
-			++this_it, ++other_it;
-		}
+		par::thread_pool::instance().parallel_for(0, rows, par::thread_pool::grain_for(columns), [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t i = from; i < to; ++i) {
+				const auto* const this_row = get_unchecked(i).data();
+				const auto* const other_row = other.get_unchecked(i).data();
+				auto* const result_row = result.get_unchecked(i).data();
+
+				for (std::size_t q = 0; q < columns; ++q)
+					result_row[q] = this_row[q] - other_row[q];
+			}
+		});
 
 		return std::move(result);
 	}
 
 	template <numeric T> [[nodiscard]] inline matrix<T> matrix<T>::mul_unchecked(const matrix& other) const noexcept {
-		matrix result(rows_number(), other.columns_number());
+		const auto inner = columns_number();
+		const auto columns = other.columns_number();
+
+		AGLA_INSTRUMENT(mul, rows_number(), columns, 2 * rows_number() * inner * columns, (rows_number() * inner + inner * columns + rows_number() * columns) * sizeof(T));
+
+		matrix result(rows_number(), columns, get_allocator());
+
+		par::thread_pool::instance().parallel_for(0, result.rows_number(), par::thread_pool::grain_for(inner * columns), [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t i = from; i < to; ++i) {
+				const auto& row = get_unchecked(i);
+				auto* const result_row = result.get_unchecked(i).data();
 
-		for (int i = 0; i < result.rows_number(); ++i)
-			for (int q = 0; q < result.columns_number(); ++q)
-				for (int j = 0; j < columns_number(); ++j)
-					result.get_unchecked(i).get_unchecked(q) +=
-						this->get_unchecked(i).get_unchecked(j) *
-						other.get_unchecked(j).get_unchecked(q);
+				for (std::size_t j = 0; j < inner; ++j)
+					kernels::axpy(row.get_unchecked(j), other.get_unchecked(j).data(), result_row, columns);
+			}
+		});
 
 		return std::move(result);
 	}
 
-	template <numeric T> [[nodiscard]] inline std::optional<matrix<T>> matrix<T>::operator+(const matrix& other) const noexcept {
-		const auto rows = rows_number();
-		const auto columns = columns_number();
+	template <numeric T> [[nodiscard]] inline matrix<T> matrix<T>::mul_unchecked(const transpose_view<T>& other) const noexcept {
+		const auto inner = columns_number();
+		const auto columns = other.columns_number();
 
-		if (rows != other.rows_number() || columns != other.columns_number())
-			return std::nullopt;
+		AGLA_INSTRUMENT(mul_transposed, rows_number(), columns, 2 * rows_number() * inner * columns, (rows_number() * inner + inner * columns + rows_number() * columns) * sizeof(T));
 
-		matrix result(rows, columns);
+		matrix result(rows_number(), columns, get_allocator());
 
-		auto this_it = begin();
-		auto other_it = other.begin();
+		par::thread_pool::instance().parallel_for(0, result.rows_number(), par::thread_pool::grain_for(inner * columns), [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t i = from; i < to; ++i) {
+				const auto* const row = get_unchecked(i).data();
+				auto* const result_row = result.get_unchecked(i).data();
 
-		for (auto& elem : result) {
-			elem = *this_it + *other_it;
-			++this_it, ++other_it;
-		}
+				for (std::size_t j = 0; j < columns; ++j)
+					result_row[j] = kernels::dot(row, other.source.get_unchecked(j).data(), inner);
+			}
+		});
 
-		return std::make_optional(result);
+		return result;
 	}
 
-	template <numeric T> [[nodiscard]] inline std::optional<matrix<T>> matrix<T>::operator-(const matrix& other) const noexcept {
+	template <numeric T> [[nodiscard]] inline std::optional<matrix<T>> matrix<T>::operator+(const matrix& other) const noexcept {
 		const auto rows = rows_number();
 		const auto columns = columns_number();
 
 		if (rows != other.rows_number() || columns != other.columns_number())
 			return std::nullopt;
 
-		matrix result(rows, columns);
+		return std::make_optional(add_unchecked(other));
+	}
 
-		auto this_it = begin();
-		auto other_it = other.begin();
+	template <numeric T> [[nodiscard]] inline std::optional<matrix<T>> matrix<T>::operator-(const matrix& other) const noexcept {
+		const auto rows = rows_number();
+		const auto columns = columns_number();
 
-		for (auto& elem : result) {
-			elem = *this_it - *other_it;
-			++this_it, ++other_it;
-		}
+		if (rows != other.rows_number() || columns != other.columns_number())
+			return std::nullopt;
 
-		return std::make_optional(result);
+		return std::make_optional(sub_unchecked(other));
 	}
 
 	template <numeric T> [[nodiscard]] inline std::optional<matrix<T>> matrix<T>::operator* (const matrix& other) const noexcept {
 		if (columns_number() != other.rows_number())
 			return std::nullopt;
 
-		matrix result(rows_number(), other.columns_number());
+		return std::make_optional(mul_unchecked(other));
+	}
 
-		for (int i = 0; i < result.rows_number(); ++i)
-			for (int q = 0; q < result.columns_number(); ++q)
-				for (int j = 0; j < columns_number(); ++j)
-					result.get_unchecked(i).get_unchecked(q) +=
-						this->get_unchecked(i).get_unchecked(j) *
-						other.get_unchecked(j).get_unchecked(q);
+	template <numeric T> [[nodiscard]] inline std::optional<matrix<T>> matrix<T>::operator* (const transpose_view<T>& other) const noexcept {
+		if (columns_number() != other.rows_number())
+			return std::nullopt;
 
-		return std::make_optional(result);
+		return std::make_optional(mul_unchecked(other));
 	}
 
 	template <numeric T> [[nodiscard]] inline bool matrix<T>::operator== (const matrix& other) const noexcept {
@@ -254,15 +341,40 @@ namespace agla::mtx {
 	}
 
 	template <numeric T> [[nodiscard]] inline matrix<T> matrix<T>::transposed() const noexcept {
-		matrix result(columns_number(), rows_number());
+		const auto rows = rows_number();
+		const auto columns = columns_number();
+
+		AGLA_INSTRUMENT(transpose, rows, columns, 0, 2 * rows * columns * sizeof(T));
+
+		matrix result(columns, rows, get_allocator());
+		std::vector<const T*> src(rows);
+		std::vector<T*> dst(columns);
+
+		for (std::size_t i = 0; i < rows; ++i)
+			src[i] = get_unchecked(i).data();
 
-		for (int i = 0; i < result.rows_number(); ++i)
-			for (int q = 0; q <result.columns_number(); ++q)
-				result.get_unchecked(i).get_unchecked(q) = get_unchecked(q).get_unchecked(i);
+		for (std::size_t q = 0; q < columns; ++q)
+			dst[q] = result.get_unchecked(q).data();
+
+		// Split the longer side across threads, so every task writes its own block of the result
+		auto& pool = par::thread_pool::instance();
+
+		if (rows >= columns)
+			pool.parallel_for(0, rows, par::thread_pool::grain_for(columns), [&](const std::size_t from, const std::size_t to) {
+				kernels::transpose(src.data(), dst.data(), from, to, 0, columns);
+			});
+		else
+			pool.parallel_for(0, columns, par::thread_pool::grain_for(rows), [&](const std::size_t from, const std::size_t to) {
+				kernels::transpose(src.data(), dst.data(), 0, rows, from, to);
+			});
 
 		return result;
 	}
 
+	template <numeric T> [[nodiscard]] inline transpose_view<T> matrix<T>::transposed_view() const noexcept {
+		return transpose_view<T> { *this };
+	}
+
 	template <numeric T> [[nodiscard]] inline bool matrix<T>::diagonals_greater_than_rows() const noexcept {
 		return std::all_of(
 			rows_begin(),
@@ -280,6 +392,16 @@ namespace agla::mtx {
 		);
 	}
 
+	template <numeric T> [[nodiscard]] inline T matrix<T>::one_norm() const noexcept {
+		std::vector<T> sums(columns_number(), T(0));
+
+		for (const auto& row : mtx)
+			for (std::size_t q = 0; q < sums.size(); ++q)
+				sums[q] += std::abs(row.get_unchecked(q));
+
+		return sums.empty() ? T(0) : *std::max_element(sums.begin(), sums.end());
+	}
+
 	// ----------------------- Iterators -----------------------
 
 	template <numeric T> [[nodiscard]] inline matrix<T>::row_iterator matrix<T>::rows_begin() noexcept { return row_iterator(mtx.begin()); }
@@ -294,6 +416,76 @@ namespace agla::mtx {
 	template <numeric T> [[nodiscard]] inline matrix<T>::iterator matrix<T>::end() noexcept { return iter(rows_end(), mtx.back().end()); }
 	template <numeric T> [[nodiscard]] inline matrix<T>::const_iterator matrix<T>::end() const noexcept { return const_iter(rows_end(), mtx.back().end()); }
 
+	// ########################## Transpose View ##########################
+
+	template <numeric T> [[nodiscard]] inline matrix<T> transpose_view<T>::mul_unchecked(const matrix<T>& other) const noexcept {
+		constexpr std::size_t small_result = 1 << 12;
+		constexpr std::size_t max_blocks = 64;
+
+		const auto rows = rows_number();
+		const auto inner = columns_number();
+		const auto columns = other.columns_number();
+
+		AGLA_INSTRUMENT(mul_transposed, rows, columns, 2 * rows * inner * columns, (rows * inner + inner * columns + rows * columns) * sizeof(T));
+
+		auto& pool = par::thread_pool::instance();
+		matrix<T> result(rows, columns, source.get_allocator());
+
+		// Large results: each task owns a band of result rows and streams over A once
+
+		if (rows * columns > small_result) {
+			pool.parallel_for(0, rows, par::thread_pool::grain_for(inner * columns), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t k = 0; k < inner; ++k) {
+					const auto* const source_row = source.get_unchecked(k).data();
+					const auto* const other_row = other.get_unchecked(k).data();
+
+					for (std::size_t i = from; i < to; ++i)
+						kernels::axpy(source_row[i], other_row, result.get_unchecked(i).data(), columns);
+				}
+			});
+
+			return result;
+		}
+
+		// Small results (Gram matrices of tall designs): fixed blocks of rows of A accumulate
+		// private partial products that are summed in order, independent of the thread count.
+		// Each partial starts on its own cache line, so no two tasks write to a shared one
+
+		constexpr auto line_elements = std::max<std::size_t>(aligned_resource::line / sizeof(T), 1);
+
+		const auto block_rows = std::max(par::thread_pool::grain_for(rows * columns), (inner + max_blocks - 1) / max_blocks);
+		const auto blocks = (inner + block_rows - 1) / block_rows;
+		const auto stride = (rows * columns + line_elements - 1) / line_elements * line_elements;
+		std::pmr::vector<T> partial(blocks * stride, T(0), aligned_resource::instance());
+
+		pool.parallel_for(0, blocks, 1, [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t b = from; b < to; ++b) {
+				auto* const acc = partial.data() + b * stride;
+
+				for (std::size_t k = b * block_rows; k < std::min(inner, (b + 1) * block_rows); ++k) {
+					const auto* const source_row = source.get_unchecked(k).data();
+					const auto* const other_row = other.get_unchecked(k).data();
+
+					for (std::size_t i = 0; i < rows; ++i)
+						kernels::axpy(source_row[i], other_row, acc + i * columns, columns);
+				}
+			}
+		});
+
+		for (std::size_t i = 0; i < rows; ++i)
+			for (std::size_t b = 0; b < blocks; ++b)
+				kernels::axpy(T(1), partial.data() + b * stride + i * columns, result.get_unchecked(i).data(), columns);
+
+		return result;
+	}
+
+	template <numeric T> [[nodiscard]] inline std::optional<matrix<T>> transpose_view<T>::operator* (const matrix<T>& other) const noexcept {
+		if (columns_number() != other.rows_number())
+			return std::nullopt;
+
+		return std::make_optional(mul_unchecked(other));
+	}
+
 	// ----------------------- Iterators -----------------------
 
 	template matrix<double>::iterator matrix<double>::iter(matrix<double>::row_iterator row_it, matrix<double>::matrix_row::iterator it) noexcept;
@@ -301,12 +493,15 @@ namespace agla::mtx {
 
 	// ----------------------- Constructors -----------------------
 
-	template matrix<double>::matrix(std::size_t size) noexcept;
-	template matrix<double>::matrix(std::size_t rows, std::size_t columns) noexcept;
-	template matrix<double>::matrix(std::size_t rows, const std::vector<double>& row) noexcept;
-	template matrix<double>::matrix(std::size_t rows, std::vector<double>&& row) noexcept;
-	template matrix<double>::matrix(const std::vector<std::vector<double>>& matrix) noexcept;
-	template matrix<double>::matrix(std::vector<std::vector<double>>&& matrix) noexcept;
+	template matrix<double>::matrix(std::size_t size, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix(std::size_t rows, std::size_t columns, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix(std::size_t rows, const std::vector<double>& row, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix(std::size_t rows, std::vector<double>&& row, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix(const std::vector<std::vector<double>>& matrix, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix(std::vector<std::vector<double>>&& matrix, const allocator_type& allocator) noexcept;
+	template matrix<double>::matrix(const matrix& other) noexcept;
+	template matrix<double>::matrix(const matrix& other, const allocator_type& allocator) noexcept;
+	template matrix<double>::~matrix() noexcept;
 
 	// ----------------------- Accessors -----------------------
 
@@ -324,17 +519,21 @@ namespace agla::mtx {
 	template matrix<double> matrix<double>::add_unchecked(const matrix& other) const noexcept;
 	template matrix<double> matrix<double>::sub_unchecked(const matrix& other) const noexcept;
 	template matrix<double> matrix<double>::mul_unchecked(const matrix& other) const noexcept;
+	template matrix<double> matrix<double>::mul_unchecked(const transpose_view<double>& other) const noexcept;
 
 	template std::optional<matrix<double>> matrix<double>::operator+(const matrix& other) const noexcept;
 	template std::optional<matrix<double>> matrix<double>::operator-(const matrix& other) const noexcept;
 	template std::optional<matrix<double>> matrix<double>::operator* (const matrix& other) const noexcept;
+	template std::optional<matrix<double>> matrix<double>::operator* (const transpose_view<double>& other) const noexcept;
 
 	template bool matrix<double>::operator== (const matrix& other) const noexcept;
 	template bool matrix<double>::operator!= (const matrix& other) const noexcept;
 	template matrix<double>& matrix<double>::operator=(const matrix& matrix) noexcept;
 
 	template matrix<double> matrix<double>::transposed() const noexcept;
+	template transpose_view<double> matrix<double>::transposed_view() const noexcept;
 	template bool matrix<double>::diagonals_greater_than_rows() const noexcept;
+	template double matrix<double>::one_norm() const noexcept;
 
 	// ----------------------- Iterators -----------------------
 
@@ -349,4 +548,141 @@ namespace agla::mtx {
 
 	template matrix<double>::iterator matrix<double>::end() noexcept;
 	template matrix<double>::const_iterator matrix<double>::end() const noexcept;
+
+	// ----------------------- Iterators -----------------------
+
+	template matrix<float>::iterator matrix<float>::iter(matrix<float>::row_iterator row_it, matrix<float>::matrix_row::iterator it) noexcept;
+	template matrix<float>::const_iterator matrix<float>::const_iter(const_row_iterator row_it, matrix_row::const_iterator it) const noexcept;
+
+	// ----------------------- Constructors -----------------------
+
+	template matrix<float>::matrix(std::size_t size, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix(std::size_t rows, std::size_t columns, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix(std::size_t rows, const std::vector<float>& row, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix(std::size_t rows, std::vector<float>&& row, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix(const std::vector<std::vector<float>>& matrix, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix(std::vector<std::vector<float>>&& matrix, const allocator_type& allocator) noexcept;
+	template matrix<float>::matrix(const matrix& other) noexcept;
+	template matrix<float>::matrix(const matrix& other, const allocator_type& allocator) noexcept;
+	template matrix<float>::~matrix() noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t matrix<float>::rows_number() const noexcept;
+	template std::size_t matrix<float>::columns_number() const noexcept;
+
+	template matrix<float>::matrix_row& matrix<float>::get_unchecked(std::size_t index) noexcept;
+	template const matrix<float>::matrix_row& matrix<float>::get_unchecked(std::size_t index) const noexcept;
+
+	template std::optional<std::reference_wrapper<matrix<float>::matrix_row>> matrix<float>::operator[](std::size_t index) noexcept;
+	template std::optional<std::reference_wrapper<const matrix<float>::matrix_row>> matrix<float>::operator[](std::size_t index) const noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template matrix<float> matrix<float>::add_unchecked(const matrix& other) const noexcept;
+	template matrix<float> matrix<float>::sub_unchecked(const matrix& other) const noexcept;
+	template matrix<float> matrix<float>::mul_unchecked(const matrix& other) const noexcept;
+	template matrix<float> matrix<float>::mul_unchecked(const transpose_view<float>& other) const noexcept;
+
+	template std::optional<matrix<float>> matrix<float>::operator+(const matrix& other) const noexcept;
+	template std::optional<matrix<float>> matrix<float>::operator-(const matrix& other) const noexcept;
+	template std::optional<matrix<float>> matrix<float>::operator* (const matrix& other) const noexcept;
+	template std::optional<matrix<float>> matrix<float>::operator* (const transpose_view<float>& other) const noexcept;
+
+	template bool matrix<float>::operator== (const matrix& other) const noexcept;
+	template bool matrix<float>::operator!= (const matrix& other) const noexcept;
+	template matrix<float>& matrix<float>::operator=(const matrix& matrix) noexcept;
+
+	template matrix<float> matrix<float>::transposed() const noexcept;
+	template transpose_view<float> matrix<float>::transposed_view() const noexcept;
+	template bool matrix<float>::diagonals_greater_than_rows() const noexcept;
+	template float matrix<float>::one_norm() const noexcept;
+
+	// ----------------------- Iterators -----------------------
+
+	template matrix<float>::row_iterator matrix<float>::rows_begin() noexcept;
+	template matrix<float>::const_row_iterator matrix<float>::rows_begin() const noexcept;
+
+	template matrix<float>::row_iterator matrix<float>::rows_end() noexcept;
+	template matrix<float>::const_row_iterator matrix<float>::rows_end() const noexcept;
+
+	template matrix<float>::iterator matrix<float>::begin() noexcept;
+	template matrix<float>::const_iterator matrix<float>::begin() const noexcept;
+
+	template matrix<float>::iterator matrix<float>::end() noexcept;
+	template matrix<float>::const_iterator matrix<float>::end() const noexcept;
+
+	// ----------------------- Iterators -----------------------
+
+	template matrix<long double>::iterator matrix<long double>::iter(matrix<long double>::row_iterator row_it, matrix<long double>::matrix_row::iterator it) noexcept;
+	template matrix<long double>::const_iterator matrix<long double>::const_iter(const_row_iterator row_it, matrix_row::const_iterator it) const noexcept;
+
+	// ----------------------- Constructors -----------------------
+
+	template matrix<long double>::matrix(std::size_t size, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix(std::size_t rows, std::size_t columns, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix(std::size_t rows, const std::vector<long double>& row, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix(std::size_t rows, std::vector<long double>&& row, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix(const std::vector<std::vector<long double>>& matrix, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix(std::vector<std::vector<long double>>&& matrix, const allocator_type& allocator) noexcept;
+	template matrix<long double>::matrix(const matrix& other) noexcept;
+	template matrix<long double>::matrix(const matrix& other, const allocator_type& allocator) noexcept;
+	template matrix<long double>::~matrix() noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t matrix<long double>::rows_number() const noexcept;
+	template std::size_t matrix<long double>::columns_number() const noexcept;
+
+	template matrix<long double>::matrix_row& matrix<long double>::get_unchecked(std::size_t index) noexcept;
+	template const matrix<long double>::matrix_row& matrix<long double>::get_unchecked(std::size_t index) const noexcept;
+
+	template std::optional<std::reference_wrapper<matrix<long double>::matrix_row>> matrix<long double>::operator[](std::size_t index) noexcept;
+	template std::optional<std::reference_wrapper<const matrix<long double>::matrix_row>> matrix<long double>::operator[](std::size_t index) const noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template matrix<long double> matrix<long double>::add_unchecked(const matrix& other) const noexcept;
+	template matrix<long double> matrix<long double>::sub_unchecked(const matrix& other) const noexcept;
+	template matrix<long double> matrix<long double>::mul_unchecked(const matrix& other) const noexcept;
+	template matrix<long double> matrix<long double>::mul_unchecked(const transpose_view<long double>& other) const noexcept;
+
+	template std::optional<matrix<long double>> matrix<long double>::operator+(const matrix& other) const noexcept;
+	template std::optional<matrix<long double>> matrix<long double>::operator-(const matrix& other) const noexcept;
+	template std::optional<matrix<long double>> matrix<long double>::operator* (const matrix& other) const noexcept;
+	template std::optional<matrix<long double>> matrix<long double>::operator* (const transpose_view<long double>& other) const noexcept;
+
+	template bool matrix<long double>::operator== (const matrix& other) const noexcept;
+	template bool matrix<long double>::operator!= (const matrix& other) const noexcept;
+	template matrix<long double>& matrix<long double>::operator=(const matrix& matrix) noexcept;
+
+	template matrix<long double> matrix<long double>::transposed() const noexcept;
+	template transpose_view<long double> matrix<long double>::transposed_view() const noexcept;
+	template bool matrix<long double>::diagonals_greater_than_rows() const noexcept;
+	template long double matrix<long double>::one_norm() const noexcept;
+
+	// ----------------------- Iterators -----------------------
+
+	template matrix<long double>::row_iterator matrix<long double>::rows_begin() noexcept;
+	template matrix<long double>::const_row_iterator matrix<long double>::rows_begin() const noexcept;
+
+	template matrix<long double>::row_iterator matrix<long double>::rows_end() noexcept;
+	template matrix<long double>::const_row_iterator matrix<long double>::rows_end() const noexcept;
+
+	template matrix<long double>::iterator matrix<long double>::begin() noexcept;
+	template matrix<long double>::const_iterator matrix<long double>::begin() const noexcept;
+
+	template matrix<long double>::iterator matrix<long double>::end() noexcept;
+	template matrix<long double>::const_iterator matrix<long double>::end() const noexcept;
+
+	// ########################## Transpose View ##########################
+
+	template matrix<double> transpose_view<double>::mul_unchecked(const matrix<double>& other) const noexcept;
+	template std::optional<matrix<double>> transpose_view<double>::operator* (const matrix<double>& other) const noexcept;
+
+	template matrix<float> transpose_view<float>::mul_unchecked(const matrix<float>& other) const noexcept;
+	template std::optional<matrix<float>> transpose_view<float>::operator* (const matrix<float>& other) const noexcept;
+
+	template matrix<long double> transpose_view<long double>::mul_unchecked(const matrix<long double>& other) const noexcept;
+	template std::optional<matrix<long double>> transpose_view<long double>::operator* (const matrix<long double>& other) const noexcept;
 }
\ No newline at end of file
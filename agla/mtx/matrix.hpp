@@ -3,23 +3,33 @@
 
 #include <iostream>
 #include <vector>
+#include <memory_resource>
 #include <optional>
 #include <iterator>
 #include <algorithm>
 #include <type_traits>
+#include <concepts>
+
+#include "instrumentation.hpp"
 
 namespace agla {
 	template <typename NumericType> concept numeric = std::is_arithmetic<NumericType>::value;
 
 	namespace mtx {
+		template <numeric T> struct transpose_view;
+
 		template <numeric T> struct matrix {
 
+			// Rows and the row table come from the same memory resource, so a matrix can live in an arena
+			using allocator_type = std::pmr::polymorphic_allocator<T>;
+
 			// ########################## Matrix Row ##########################
 
 			class matrix_row {
-				std::vector<T> row;
+				std::pmr::vector<T> row;
 
 			 public:
+				using allocator_type = std::pmr::polymorphic_allocator<T>;
 
 				// ----------------------- Iterators -----------------------
 
@@ -37,8 +47,8 @@ namespace agla {
 
 				 private:
 					friend class matrix_row;
-					std::vector<T>::iterator row_it;
-					explicit iterator(std::vector<T>::iterator row_it) noexcept : row_it(row_it) {}
+					std::pmr::vector<T>::iterator row_it;
+					explicit iterator(std::pmr::vector<T>::iterator row_it) noexcept : row_it(row_it) {}
 
 				 public:
 					~iterator() noexcept = default;
@@ -90,8 +100,8 @@ namespace agla {
 
 				 private:
 					friend class matrix_row;
-					std::vector<T>::const_iterator row_it;
-					explicit const_iterator(std::vector<T>::const_iterator row_it) noexcept : row_it(row_it) {}
+					std::pmr::vector<T>::const_iterator row_it;
+					explicit const_iterator(std::pmr::vector<T>::const_iterator row_it) noexcept : row_it(row_it) {}
 
 				 public:
 					~const_iterator() noexcept = default;
@@ -135,22 +145,35 @@ namespace agla {
 
 				matrix_row() noexcept;
 
-				explicit matrix_row(std::size_t size) noexcept;
-				matrix_row(std::size_t size, const T& elem) noexcept;
-				matrix_row(std::size_t size, T&& elem) noexcept;
+				explicit matrix_row(std::size_t size, const allocator_type& allocator = {}) noexcept;
+				matrix_row(std::size_t size, const T& elem, const allocator_type& allocator = {}) noexcept;
+				matrix_row(std::size_t size, T&& elem, const allocator_type& allocator = {}) noexcept;
+
+				explicit matrix_row(const std::vector<T>& row, const allocator_type& allocator = {}) noexcept;
+				explicit matrix_row(std::vector<T>&& row, const allocator_type& allocator = {}) noexcept;
+
+				matrix_row(const matrix_row& other) noexcept = default;
+				matrix_row(matrix_row&& other) noexcept = default;
 
-				explicit matrix_row(const std::vector<T>& row) noexcept;
-				explicit matrix_row(std::vector<T>&& row) noexcept;
+				matrix_row(const matrix_row& other, const allocator_type& allocator) noexcept;
+				matrix_row(matrix_row&& other, const allocator_type& allocator) noexcept;
+
+				matrix_row& operator=(const matrix_row& other) noexcept = default;
+				matrix_row& operator=(matrix_row&& other) noexcept = default;
 
 				// ----------------------- Accessors -----------------------
 
 				[[nodiscard]] inline std::size_t size() const noexcept;
+				[[nodiscard]] inline allocator_type get_allocator() const noexcept { return row.get_allocator(); }
 
 				[[nodiscard]] inline T& get_unchecked(std::size_t index) noexcept;
 				[[nodiscard]] inline const T& get_unchecked(std::size_t index) const noexcept;
 
 				[[nodiscard]] inline std::optional<std::reference_wrapper<T>> operator[](std::size_t index) noexcept;
 
+				[[nodiscard]] inline T* data() noexcept { return row.data(); }
+				[[nodiscard]] inline const T* data() const noexcept { return row.data(); }
+
 				// ----------------------- Operators -----------------------
 
 				[[nodiscard]] inline std::optional<matrix_row> operator+(const matrix_row& other) const noexcept;
@@ -166,7 +189,7 @@ namespace agla {
 			};
 
 		 protected:
-			std::vector<matrix_row> mtx;
+			std::pmr::vector<matrix_row> mtx;
 
 			// ----------------------- Row Iterators -----------------------
 
@@ -184,8 +207,8 @@ namespace agla {
 
 			 private:
 				friend class matrix;
-				std::vector<matrix_row>::iterator it;
-				explicit row_iterator(std::vector<matrix_row>::iterator it) noexcept : it(it) {}
+				std::pmr::vector<matrix_row>::iterator it;
+				explicit row_iterator(std::pmr::vector<matrix_row>::iterator it) noexcept : it(it) {}
 
 			 public:
 				~row_iterator() noexcept = default;
@@ -237,8 +260,8 @@ namespace agla {
 
 			 private:
 				friend class matrix;
-				std::vector<matrix_row>::const_iterator it;
-				explicit const_row_iterator(std::vector<matrix_row>::const_iterator it) noexcept : it(it) {}
+				std::pmr::vector<matrix_row>::const_iterator it;
+				explicit const_row_iterator(std::pmr::vector<matrix_row>::const_iterator it) noexcept : it(it) {}
 
 			 public:
 				~const_row_iterator() noexcept = default;
@@ -422,14 +445,19 @@ namespace agla {
 
 			// ----------------------- Constructors -----------------------
 
-			explicit matrix(std::size_t size) noexcept;
+			explicit matrix(std::size_t size, const allocator_type& allocator = {}) noexcept;
+
+			matrix(std::size_t rows, std::size_t columns, const allocator_type& allocator = {}) noexcept;
+			matrix(std::size_t rows, const std::vector<T>& row, const allocator_type& allocator = {}) noexcept;
+			matrix(std::size_t rows, std::vector<T>&& row, const allocator_type& allocator = {}) noexcept;
 
-			matrix(std::size_t rows, std::size_t columns) noexcept;
-			matrix(std::size_t rows, const std::vector<T>& row) noexcept;
-			matrix(std::size_t rows, std::vector<T>&& row) noexcept;
+			explicit matrix(const std::vector<std::vector<T>>& matrix, const allocator_type& allocator = {}) noexcept;
+			explicit matrix(std::vector<std::vector<T>>&& matrix, const allocator_type& allocator = {}) noexcept;
 
-			explicit matrix(const std::vector<std::vector<T>>& matrix) noexcept;
-			explicit matrix(std::vector<std::vector<T>>&& matrix) noexcept;
+			// Copies stay in the source's memory resource unless another one is given
+			matrix(const matrix& other) noexcept;
+			matrix(const matrix& other, const allocator_type& allocator) noexcept;
+			matrix(matrix&& other) noexcept = default;
 
 			~matrix() noexcept;
 
@@ -437,6 +465,7 @@ namespace agla {
 
 			[[nodiscard]] inline std::size_t rows_number() const noexcept;
 			[[nodiscard]] inline std::size_t columns_number() const noexcept;
+			[[nodiscard]] inline allocator_type get_allocator() const noexcept { return mtx.get_allocator(); }
 
 			[[nodiscard]] inline matrix_row& get_unchecked(std::size_t index) noexcept;
 			[[nodiscard]] const matrix_row& get_unchecked(std::size_t index) const noexcept;
@@ -449,10 +478,12 @@ namespace agla {
 			[[nodiscard]] inline matrix add_unchecked(const matrix& other) const noexcept;
 			[[nodiscard]] inline matrix sub_unchecked(const matrix& other) const noexcept;
 			[[nodiscard]] inline matrix mul_unchecked (const matrix& other) const noexcept;
+			[[nodiscard]] inline matrix mul_unchecked (const transpose_view<T>& other) const noexcept;
 
 			[[nodiscard]] inline std::optional<matrix> operator+(const matrix& other) const noexcept;
 			[[nodiscard]] inline std::optional<matrix> operator-(const matrix& other) const noexcept;
 			[[nodiscard]] inline std::optional<matrix> operator* (const matrix& other) const noexcept;
+			[[nodiscard]] inline std::optional<matrix> operator* (const transpose_view<T>& other) const noexcept;
 
 			[[nodiscard]] inline bool operator== (const matrix& other) const noexcept;
 			[[nodiscard]] inline bool operator!= (const matrix& other) const noexcept;
@@ -460,8 +491,14 @@ namespace agla {
 			inline matrix& operator=(const matrix& matrix) noexcept;
 
 			[[nodiscard]] inline matrix transposed() const noexcept;
+
+			// Zero-copy A^T; the view refers to *this, which must outlive it
+			[[nodiscard]] inline transpose_view<T> transposed_view() const noexcept;
 			[[nodiscard]] inline bool diagonals_greater_than_rows() const noexcept;
 
+			// Largest absolute column sum
+			[[nodiscard]] inline T one_norm() const noexcept;
+
 			// ----------------------- Iterators -----------------------
 
 			[[nodiscard]] inline row_iterator rows_begin() noexcept;
@@ -477,9 +514,26 @@ namespace agla {
 			[[nodiscard]] inline const_iterator end() const noexcept;
 		};
 
+		// ########################## Transpose View ##########################
+
+		// Products with the view read the source rows directly instead of copying A^T
+		template <numeric T> struct transpose_view {
+			const matrix<T>& source;
+
+			[[nodiscard]] inline std::size_t rows_number() const noexcept { return source.columns_number(); }
+			[[nodiscard]] inline std::size_t columns_number() const noexcept { return source.rows_number(); }
+
+			[[nodiscard]] inline matrix<T> mul_unchecked(const matrix<T>& other) const noexcept;
+			[[nodiscard]] inline std::optional<matrix<T>> operator* (const matrix<T>& other) const noexcept;
+
+			[[nodiscard]] inline matrix<T> materialized() const noexcept { return source.transposed(); }
+		};
+
 		// ----------------------- Extensions -----------------------
 
 		template <numeric T> inline std::istream& operator >> (std::istream& in, matrix<T>& mtx) noexcept {
+			AGLA_INSTRUMENT(read, mtx.rows_number(), mtx.columns_number(), 0, mtx.rows_number() * mtx.columns_number() * sizeof(T));
+
 			for (auto& cell : mtx)
 				in >> cell;
 
@@ -487,6 +541,8 @@ namespace agla {
 		}
 
 		template <numeric T> inline std::ostream& operator << (std::ostream& out, const matrix<T>& mtx) noexcept {
+			AGLA_INSTRUMENT(write, mtx.rows_number(), mtx.columns_number(), 0, mtx.rows_number() * mtx.columns_number() * sizeof(T));
+
 			for (auto row_it = mtx.rows_begin(); row_it != mtx.rows_end(); ++row_it) {
 				std::copy(row_it->begin(), std::prev(row_it->end()), std::ostream_iterator<T>(out, " "));
 				out << *std::prev(row_it->end()) << std::endl;
@@ -495,17 +551,19 @@ namespace agla {
 			return out;
 		}
 
-		template <> inline std::ostream& operator << (std::ostream& out, const matrix<double>& mtx) noexcept {
+		template <numeric T> requires std::floating_point<T> inline std::ostream& operator << (std::ostream& out, const matrix<T>& mtx) noexcept {
+			AGLA_INSTRUMENT(write, mtx.rows_number(), mtx.columns_number(), 0, mtx.rows_number() * mtx.columns_number() * sizeof(T));
+
 			for (auto row_it = mtx.rows_begin(); row_it != mtx.rows_end(); ++row_it) {
 				std::transform(
 					row_it->begin(),
 					std::prev(row_it->end()),
-					std::ostream_iterator<double>(out, " "),
-					[](const auto& x) { return x == 0 ? 0 : x; }
+					std::ostream_iterator<T>(out, " "),
+					[](const auto& x) { return x == 0 ? T(0) : x; }
 				);
 
 				const auto last = *std::prev(row_it->end());
-				out << (last == 0 ? 0 : last) << std::endl;
+				out << (last == 0 ? T(0) : last) << std::endl;
 			}
 
 			return out;
@@ -0,0 +1,88 @@
+#ifndef NORM_ESTIMATE_HPP
+#define NORM_ESTIMATE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "matrix.hpp"
+
+namespace agla::mtx {
+
+	// Hager's estimate of ||A^-1||_1 with Higham's alternating-sign safeguard (as in LAPACK xLACN2).
+	// Needs a handful of solves with A and A^T, O(n^2) on an existing factorization; the result
+	// is a lower bound that is almost always within a factor of 3 of the true norm.
+	// solve(x) and solve_transposed(x) overwrite x with A^-1 * x and A^-T * x
+	template <numeric T, typename Solve, typename SolveTransposed> [[nodiscard]] inline T inverse_one_norm_estimate(
+		const std::size_t size,
+		Solve&& solve,
+		SolveTransposed&& solve_transposed
+	) noexcept {
+		constexpr std::size_t max_iterations = 5;
+
+		if (size == 0)
+			return T(0);
+
+		std::vector<T> x(size, T(1) / static_cast<T>(size));
+		std::vector<T> z(size);
+		std::size_t last = size;
+		T estimate = 0;
+
+		const auto one_norm = [&x] {
+			T acc = 0;
+
+			for (const auto& e : x)
+				acc += std::abs(e);
+
+			return acc;
+		};
+
+		for (std::size_t iteration = 0; iteration < max_iterations; ++iteration) {
+			solve(x.data());
+			const auto norm = one_norm();
+
+			if (iteration > 0 && norm <= estimate)
+				break;
+
+			estimate = norm;
+
+			for (std::size_t i = 0; i < size; ++i)
+				z[i] = x[i] >= 0 ? T(1) : T(-1);
+
+			solve_transposed(z.data());
+
+			std::size_t j = 0;
+			T z_dot_x = 0;
+
+			for (std::size_t i = 0; i < size; ++i) {
+				if (std::abs(z[i]) > std::abs(z[j]))
+					j = i;
+
+				z_dot_x += z[i];
+			}
+
+			// The previous x was e / n on the first pass and e_last afterwards
+			z_dot_x = last == size ? z_dot_x / static_cast<T>(size) : z[last];
+
+			if (std::abs(z[j]) <= z_dot_x || j == last)
+				break;
+
+			last = j;
+			std::fill(x.begin(), x.end(), T(0));
+			x[j] = 1;
+		}
+
+		const auto denominator = static_cast<T>(size > 1 ? size - 1 : 1);
+
+		for (std::size_t i = 0; i < size; ++i)
+			x[i] = (i % 2 == 0 ? T(1) : T(-1)) * (1 + static_cast<T>(i) / denominator);
+
+		solve(x.data());
+		const auto alternating = 2 * one_norm() / (3 * static_cast<T>(size));
+
+		return std::max(estimate, alternating);
+	}
+} // agla::mtx
+
+#endif // NORM_ESTIMATE_HPP
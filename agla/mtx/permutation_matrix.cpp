@@ -20,4 +20,10 @@ namespace agla::mtx {
 
 	template permutation_matrix<double>::permutation_matrix(const square_matrix<double>& mtx, std::size_t row_ind, std::size_t column_ind) noexcept;
 	template permutation_matrix<double>& permutation_matrix<double>::operator=(const permutation_matrix& matrix) noexcept;
+
+	template permutation_matrix<float>::permutation_matrix(const square_matrix<float>& mtx, std::size_t row_ind, std::size_t column_ind) noexcept;
+	template permutation_matrix<float>& permutation_matrix<float>::operator=(const permutation_matrix& matrix) noexcept;
+
+	template permutation_matrix<long double>::permutation_matrix(const square_matrix<long double>& mtx, std::size_t row_ind, std::size_t column_ind) noexcept;
+	template permutation_matrix<long double>& permutation_matrix<long double>::operator=(const permutation_matrix& matrix) noexcept;
 } // agla::mtx
\ No newline at end of file
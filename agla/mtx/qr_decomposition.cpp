@@ -0,0 +1,214 @@
+#include <cmath>
+#include <limits>
+
+#include "qr_decomposition.hpp"
+#include "kernels.hpp"
+#include "norm_estimate.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::mtx {
+
+	// ----------------------- Constructors -----------------------
+
+	template <numeric T> qr_decomposition<T>::qr_decomposition(
+		matrix<T>&& reflectors,
+		std::vector<T>&& diagonal,
+		std::vector<T>&& scales
+	) noexcept : reflectors(std::move(reflectors)), diagonal(std::move(diagonal)), scales(std::move(scales)) {}
+
+	template <numeric T> [[nodiscard]] std::optional<qr_decomposition<T>> qr_decomposition<T>::from_matrix(const matrix<T>& a) noexcept {
+		const auto rows = a.rows_number();
+		const auto columns = a.columns_number();
+
+		if (rows < columns)
+			return std::nullopt;
+
+		AGLA_INSTRUMENT(qr_factorize, rows, columns, 2 * rows * columns * columns - 2 * columns * columns * columns / 3, 2 * rows * columns * sizeof(T));
+
+		auto reflectors = a.transposed();
+		std::vector<T> diagonal(columns);
+		std::vector<T> scales(columns);
+		auto& pool = par::thread_pool::instance();
+
+		for (std::size_t k = 0; k < columns; ++k) {
+			auto* const v = reflectors.get_unchecked(k).data() + k;
+			const auto length = rows - k;
+			const auto norm = std::sqrt(kernels::sum_of_squares(v, length));
+
+			if (norm == 0) {
+				diagonal[k] = 0;
+				scales[k] = 0;
+				continue;
+			}
+
+			// H = I - tau * v * v^T maps the column onto alpha * e_1; alpha takes the sign
+			// opposite to v_0 so that v_0 - alpha does not cancel
+			const auto alpha = v[0] > 0 ? -norm : norm;
+			v[0] -= alpha;
+
+			const auto tau = 1 / (-alpha * v[0]);
+			diagonal[k] = alpha;
+			scales[k] = tau;
+
+			pool.parallel_for(k + 1, columns, par::thread_pool::grain_for(length), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t j = from; j < to; ++j) {
+					auto* const column = reflectors.get_unchecked(j).data() + k;
+					kernels::axpy(-tau * kernels::dot(v, column, length), v, column, length);
+				}
+			});
+		}
+
+		return std::make_optional(qr_decomposition(std::move(reflectors), std::move(diagonal), std::move(scales)));
+	}
+
+	// ----------------------- Accessors -----------------------
+
+	template <numeric T> [[nodiscard]] inline std::size_t qr_decomposition<T>::rows_number() const noexcept {
+		return reflectors.columns_number();
+	}
+
+	template <numeric T> [[nodiscard]] inline std::size_t qr_decomposition<T>::columns_number() const noexcept {
+		return reflectors.rows_number();
+	}
+
+	template <numeric T> [[nodiscard]] inline square_matrix<T> qr_decomposition<T>::upper_triangular() const noexcept {
+		const auto n = columns_number();
+		square_matrix<T> r(n, reflectors.get_allocator());
+
+		for (std::size_t j = 0; j < n; ++j) {
+			const auto* const column = reflectors.get_unchecked(j).data();
+
+			for (std::size_t i = 0; i < j; ++i)
+				r.get_unchecked(i).get_unchecked(j) = column[i];
+
+			r.get_unchecked(j).get_unchecked(j) = diagonal[j];
+		}
+
+		return r;
+	}
+
+	// ----------------------- Operations -----------------------
+
+	template <numeric T> inline void qr_decomposition<T>::apply_transposed_q(T* const b) const noexcept {
+		const auto m = rows_number();
+
+		for (std::size_t k = 0; k < columns_number(); ++k) {
+			const auto* const v = reflectors.get_unchecked(k).data() + k;
+			kernels::axpy(-scales[k] * kernels::dot(v, b + k, m - k), v, b + k, m - k);
+		}
+	}
+
+	template <numeric T> inline void qr_decomposition<T>::apply_transposed_q(T* const* const b, const std::size_t count) const noexcept {
+		const auto m = rows_number();
+
+		for (std::size_t k = 0; k < columns_number(); ++k) {
+			const auto* const v = reflectors.get_unchecked(k).data() + k;
+
+			for (std::size_t j = 0; j < count; ++j)
+				kernels::axpy(-scales[k] * kernels::dot(v, b[j] + k, m - k), v, b[j] + k, m - k);
+		}
+	}
+
+	template <numeric T> inline void qr_decomposition<T>::solve_upper_in_place(T* const b) const noexcept {
+		for (std::size_t j = columns_number(); j-- > 0;) {
+			b[j] /= diagonal[j];
+			kernels::axpy(-b[j], reflectors.get_unchecked(j).data(), b, j);
+		}
+	}
+
+	template <numeric T> inline void qr_decomposition<T>::solve_upper_transposed_in_place(T* const b) const noexcept {
+		for (std::size_t j = 0; j < columns_number(); ++j)
+			b[j] = (b[j] - kernels::dot(reflectors.get_unchecked(j).data(), b, j)) / diagonal[j];
+	}
+
+	template <numeric T> [[nodiscard]] inline column_vector<T> qr_decomposition<T>::solve_unchecked(const column_vector<T>& b) const noexcept {
+		const auto m = rows_number();
+		const auto n = columns_number();
+		std::vector<T> buf(m);
+
+		for (std::size_t i = 0; i < m; ++i)
+			buf[i] = b.get_unchecked(i);
+
+		apply_transposed_q(buf.data());
+		solve_upper_in_place(buf.data());
+
+		column_vector<T> result(n);
+
+		for (std::size_t i = 0; i < n; ++i)
+			result.get_unchecked(i) = buf[i];
+
+		return result;
+	}
+
+	template <numeric T> [[nodiscard]] inline T qr_decomposition<T>::condition_estimate() const noexcept {
+		const auto n = columns_number();
+		T one_norm = 0;
+
+		for (std::size_t j = 0; j < n; ++j) {
+			if (diagonal[j] == 0)
+				return std::numeric_limits<T>::infinity();
+
+			const auto* const column = reflectors.get_unchecked(j).data();
+			auto sum = std::abs(diagonal[j]);
+
+			for (std::size_t i = 0; i < j; ++i)
+				sum += std::abs(column[i]);
+
+			one_norm = std::max(one_norm, sum);
+		}
+
+		return one_norm * inverse_one_norm_estimate<T>(
+			n,
+			[this](T* const x) { solve_upper_in_place(x); },
+			[this](T* const x) { solve_upper_transposed_in_place(x); }
+		);
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	template qr_decomposition<double>::qr_decomposition(matrix<double>&& reflectors, std::vector<double>&& diagonal, std::vector<double>&& scales) noexcept;
+	template std::optional<qr_decomposition<double>> qr_decomposition<double>::from_matrix(const matrix<double>& a) noexcept;
+
+	template qr_decomposition<float>::qr_decomposition(matrix<float>&& reflectors, std::vector<float>&& diagonal, std::vector<float>&& scales) noexcept;
+	template std::optional<qr_decomposition<float>> qr_decomposition<float>::from_matrix(const matrix<float>& a) noexcept;
+
+	template qr_decomposition<long double>::qr_decomposition(matrix<long double>&& reflectors, std::vector<long double>&& diagonal, std::vector<long double>&& scales) noexcept;
+	template std::optional<qr_decomposition<long double>> qr_decomposition<long double>::from_matrix(const matrix<long double>& a) noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t qr_decomposition<double>::rows_number() const noexcept;
+	template std::size_t qr_decomposition<double>::columns_number() const noexcept;
+	template square_matrix<double> qr_decomposition<double>::upper_triangular() const noexcept;
+
+	template std::size_t qr_decomposition<float>::rows_number() const noexcept;
+	template std::size_t qr_decomposition<float>::columns_number() const noexcept;
+	template square_matrix<float> qr_decomposition<float>::upper_triangular() const noexcept;
+
+	template std::size_t qr_decomposition<long double>::rows_number() const noexcept;
+	template std::size_t qr_decomposition<long double>::columns_number() const noexcept;
+	template square_matrix<long double> qr_decomposition<long double>::upper_triangular() const noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template void qr_decomposition<double>::apply_transposed_q(double* b) const noexcept;
+	template void qr_decomposition<double>::apply_transposed_q(double* const* b, std::size_t count) const noexcept;
+	template void qr_decomposition<double>::solve_upper_in_place(double* b) const noexcept;
+	template void qr_decomposition<double>::solve_upper_transposed_in_place(double* b) const noexcept;
+	template column_vector<double> qr_decomposition<double>::solve_unchecked(const column_vector<double>& b) const noexcept;
+	template double qr_decomposition<double>::condition_estimate() const noexcept;
+
+	template void qr_decomposition<float>::apply_transposed_q(float* b) const noexcept;
+	template void qr_decomposition<float>::apply_transposed_q(float* const* b, std::size_t count) const noexcept;
+	template void qr_decomposition<float>::solve_upper_in_place(float* b) const noexcept;
+	template void qr_decomposition<float>::solve_upper_transposed_in_place(float* b) const noexcept;
+	template column_vector<float> qr_decomposition<float>::solve_unchecked(const column_vector<float>& b) const noexcept;
+	template float qr_decomposition<float>::condition_estimate() const noexcept;
+
+	template void qr_decomposition<long double>::apply_transposed_q(long double* b) const noexcept;
+	template void qr_decomposition<long double>::apply_transposed_q(long double* const* b, std::size_t count) const noexcept;
+	template void qr_decomposition<long double>::solve_upper_in_place(long double* b) const noexcept;
+	template void qr_decomposition<long double>::solve_upper_transposed_in_place(long double* b) const noexcept;
+	template column_vector<long double> qr_decomposition<long double>::solve_unchecked(const column_vector<long double>& b) const noexcept;
+	template long double qr_decomposition<long double>::condition_estimate() const noexcept;
+} // agla::mtx
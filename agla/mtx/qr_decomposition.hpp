@@ -0,0 +1,53 @@
+#ifndef QR_DECOMPOSITION_HPP
+#define QR_DECOMPOSITION_HPP
+
+#include "column_vector.hpp"
+
+namespace agla::mtx {
+
+	// Householder A = Q * R for tall (rows >= columns) matrices. The factorization works on A^T,
+	// so every column of A, and every reflector, is a contiguous row
+	template <numeric T> class qr_decomposition {
+
+		// Row k holds R[0, k) of column k above the diagonal and the reflector v_k in [k, rows)
+		matrix<T> reflectors;
+		std::vector<T> diagonal;
+		std::vector<T> scales;
+
+		qr_decomposition(matrix<T>&& reflectors, std::vector<T>&& diagonal, std::vector<T>&& scales) noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		// Returns nullopt for wide matrices
+		[[nodiscard]] static std::optional<qr_decomposition> from_matrix(const matrix<T>& a) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t rows_number() const noexcept;
+		[[nodiscard]] inline std::size_t columns_number() const noexcept;
+
+		[[nodiscard]] inline square_matrix<T> upper_triangular() const noexcept;
+
+		// ----------------------- Operations -----------------------
+
+		// b has rows_number() elements and is overwritten with Q^T * b
+		inline void apply_transposed_q(T* b) const noexcept;
+
+		// Same for count vectors at once; each reflector is streamed from memory once for all of them
+		inline void apply_transposed_q(T* const* b, std::size_t count) const noexcept;
+
+		// Solve R * x = b and R^T * x = b on the first columns_number() elements of b
+		inline void solve_upper_in_place(T* b) const noexcept;
+		inline void solve_upper_transposed_in_place(T* b) const noexcept;
+
+		// argmin ||A * x - b||; requires full column rank
+		[[nodiscard]] inline column_vector<T> solve_unchecked(const column_vector<T>& b) const noexcept;
+
+		// Estimated kappa_1(R), which tracks kappa(A); infinity when R has a zero pivot
+		[[nodiscard]] inline T condition_estimate() const noexcept;
+	};
+} // agla::mtx
+
+#endif // QR_DECOMPOSITION_HPP
@@ -0,0 +1,231 @@
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "singular_value_decomposition.hpp"
+#include "kernels.hpp"
+
+namespace agla::mtx {
+	namespace {
+		template <numeric T> inline void rotate(T* const x, T* const y, const std::size_t size, const T c, const T s) noexcept {
+			for (std::size_t i = 0; i < size; ++i) {
+				const auto xi = x[i];
+				const auto yi = y[i];
+				x[i] = c * xi - s * yi;
+				y[i] = s * xi + c * yi;
+			}
+		}
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	template <numeric T> singular_value_decomposition<T>::singular_value_decomposition(
+		matrix<T>&& left,
+		std::vector<T>&& values,
+		matrix<T>&& right
+	) noexcept : left(std::move(left)), values(std::move(values)), right(std::move(right)) {}
+
+	template <numeric T> [[nodiscard]] std::optional<singular_value_decomposition<T>> singular_value_decomposition<T>::from_matrix(
+		const matrix<T>& a,
+		const std::size_t max_sweeps
+	) noexcept {
+		const auto m = a.rows_number();
+		const auto n = a.columns_number();
+
+		if (m < n)
+			return std::nullopt;
+
+		AGLA_INSTRUMENT(svd_factorize, m, n, 0, 2 * m * n * sizeof(T));
+
+		constexpr auto epsilon = std::numeric_limits<T>::epsilon();
+
+		// Columns of A and V as rows, so each rotation touches two contiguous rows
+		auto w = a.transposed();
+		matrix<T> v(n, n, a.get_allocator());
+
+		for (std::size_t j = 0; j < n; ++j)
+			v.get_unchecked(j).get_unchecked(j) = 1;
+
+		for (std::size_t sweep = 0; sweep < max_sweeps; ++sweep) {
+			auto rotated = false;
+
+			for (std::size_t p = 0; p + 1 < n; ++p) {
+				auto* const wp = w.get_unchecked(p).data();
+
+				for (std::size_t q = p + 1; q < n; ++q) {
+					auto* const wq = w.get_unchecked(q).data();
+
+					const auto alpha = kernels::sum_of_squares(wp, m);
+					const auto beta = kernels::sum_of_squares(wq, m);
+					const auto gamma = kernels::dot(wp, wq, m);
+
+					if (gamma == 0 || std::abs(gamma) <= epsilon * std::sqrt(alpha * beta))
+						continue;
+
+					// Rotation that zeroes the (p, q) entry of W^T * W; hypot keeps t ~ 1 / (2 * zeta)
+					// where 1 + zeta^2 would overflow, and a t that still underflows is no rotation
+					const auto zeta = (beta - alpha) / (2 * gamma);
+					const auto t = (zeta >= 0 ? T(1) : T(-1)) / (std::abs(zeta) + std::hypot(T(1), zeta));
+
+					if (t == 0)
+						continue;
+
+					const auto c = 1 / std::sqrt(1 + t * t);
+					const auto s = c * t;
+
+					rotate(wp, wq, m, c, s);
+					rotate(v.get_unchecked(p).data(), v.get_unchecked(q).data(), n, c, s);
+					rotated = true;
+				}
+			}
+
+			if (!rotated)
+				break;
+		}
+
+		std::vector<T> norms(n);
+		std::vector<std::size_t> order(n);
+
+		for (std::size_t j = 0; j < n; ++j)
+			norms[j] = std::sqrt(kernels::sum_of_squares(w.get_unchecked(j).data(), m));
+
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&norms](const auto i, const auto j) { return norms[i] > norms[j]; });
+
+		matrix<T> left(n, m, a.get_allocator());
+		matrix<T> right(n, n, a.get_allocator());
+		std::vector<T> values(n);
+
+		for (std::size_t j = 0; j < n; ++j) {
+			const auto source = order[j];
+			const auto sigma = norms[source];
+			const auto* const column = w.get_unchecked(source).data();
+			auto* const u = left.get_unchecked(j).data();
+
+			values[j] = sigma;
+
+			// Null columns keep a zero u_j; they never contribute to a solve
+			if (sigma > 0)
+				for (std::size_t i = 0; i < m; ++i)
+					u[i] = column[i] / sigma;
+
+			std::copy(v.get_unchecked(source).begin(), v.get_unchecked(source).end(), right.get_unchecked(j).begin());
+		}
+
+		return std::make_optional(singular_value_decomposition(std::move(left), std::move(values), std::move(right)));
+	}
+
+	// ----------------------- Accessors -----------------------
+
+	template <numeric T> [[nodiscard]] inline std::size_t singular_value_decomposition<T>::rows_number() const noexcept {
+		return left.columns_number();
+	}
+
+	template <numeric T> [[nodiscard]] inline std::size_t singular_value_decomposition<T>::columns_number() const noexcept {
+		return values.size();
+	}
+
+	template <numeric T> [[nodiscard]] inline const std::vector<T>& singular_value_decomposition<T>::singular_values() const noexcept {
+		return values;
+	}
+
+	// ----------------------- Operations -----------------------
+
+	template <numeric T> [[nodiscard]] inline T singular_value_decomposition<T>::condition_number() const noexcept {
+		if (values.empty())
+			return T(0);
+
+		if (values.back() == 0)
+			return std::numeric_limits<T>::infinity();
+
+		return values.front() / values.back();
+	}
+
+	template <numeric T> [[nodiscard]] inline std::size_t singular_value_decomposition<T>::rank(const T relative_tolerance) const noexcept {
+		if (values.empty())
+			return 0;
+
+		const auto threshold = relative_tolerance * values.front();
+		std::size_t r = 0;
+
+		while (r < values.size() && values[r] > threshold)
+			++r;
+
+		return r;
+	}
+
+	template <numeric T> inline void singular_value_decomposition<T>::solve_in_place(T* const b, const T relative_tolerance) const noexcept {
+		const auto m = rows_number();
+		const auto n = columns_number();
+		const auto r = rank(relative_tolerance);
+		std::vector<T> x(n, T(0));
+
+		for (std::size_t j = 0; j < r; ++j)
+			kernels::axpy(kernels::dot(left.get_unchecked(j).data(), b, m) / values[j], right.get_unchecked(j).data(), x.data(), n);
+
+		std::copy(x.begin(), x.end(), b);
+	}
+
+	template <numeric T> [[nodiscard]] inline column_vector<T> singular_value_decomposition<T>::solve_unchecked(
+		const column_vector<T>& b,
+		const T relative_tolerance
+	) const noexcept {
+		const auto m = rows_number();
+		const auto n = columns_number();
+		std::vector<T> buf(m);
+
+		for (std::size_t i = 0; i < m; ++i)
+			buf[i] = b.get_unchecked(i);
+
+		solve_in_place(buf.data(), relative_tolerance);
+
+		column_vector<T> result(n);
+
+		for (std::size_t i = 0; i < n; ++i)
+			result.get_unchecked(i) = buf[i];
+
+		return result;
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	template singular_value_decomposition<double>::singular_value_decomposition(matrix<double>&& left, std::vector<double>&& values, matrix<double>&& right) noexcept;
+	template std::optional<singular_value_decomposition<double>> singular_value_decomposition<double>::from_matrix(const matrix<double>& a, std::size_t max_sweeps) noexcept;
+
+	template singular_value_decomposition<float>::singular_value_decomposition(matrix<float>&& left, std::vector<float>&& values, matrix<float>&& right) noexcept;
+	template std::optional<singular_value_decomposition<float>> singular_value_decomposition<float>::from_matrix(const matrix<float>& a, std::size_t max_sweeps) noexcept;
+
+	template singular_value_decomposition<long double>::singular_value_decomposition(matrix<long double>&& left, std::vector<long double>&& values, matrix<long double>&& right) noexcept;
+	template std::optional<singular_value_decomposition<long double>> singular_value_decomposition<long double>::from_matrix(const matrix<long double>& a, std::size_t max_sweeps) noexcept;
+
+	// ----------------------- Accessors -----------------------
+
+	template std::size_t singular_value_decomposition<double>::rows_number() const noexcept;
+	template std::size_t singular_value_decomposition<double>::columns_number() const noexcept;
+	template const std::vector<double>& singular_value_decomposition<double>::singular_values() const noexcept;
+
+	template std::size_t singular_value_decomposition<float>::rows_number() const noexcept;
+	template std::size_t singular_value_decomposition<float>::columns_number() const noexcept;
+	template const std::vector<float>& singular_value_decomposition<float>::singular_values() const noexcept;
+
+	template std::size_t singular_value_decomposition<long double>::rows_number() const noexcept;
+	template std::size_t singular_value_decomposition<long double>::columns_number() const noexcept;
+	template const std::vector<long double>& singular_value_decomposition<long double>::singular_values() const noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template double singular_value_decomposition<double>::condition_number() const noexcept;
+	template std::size_t singular_value_decomposition<double>::rank(double relative_tolerance) const noexcept;
+	template void singular_value_decomposition<double>::solve_in_place(double* b, double relative_tolerance) const noexcept;
+	template column_vector<double> singular_value_decomposition<double>::solve_unchecked(const column_vector<double>& b, double relative_tolerance) const noexcept;
+
+	template float singular_value_decomposition<float>::condition_number() const noexcept;
+	template std::size_t singular_value_decomposition<float>::rank(float relative_tolerance) const noexcept;
+	template void singular_value_decomposition<float>::solve_in_place(float* b, float relative_tolerance) const noexcept;
+	template column_vector<float> singular_value_decomposition<float>::solve_unchecked(const column_vector<float>& b, float relative_tolerance) const noexcept;
+
+	template long double singular_value_decomposition<long double>::condition_number() const noexcept;
+	template std::size_t singular_value_decomposition<long double>::rank(long double relative_tolerance) const noexcept;
+	template void singular_value_decomposition<long double>::solve_in_place(long double* b, long double relative_tolerance) const noexcept;
+	template column_vector<long double> singular_value_decomposition<long double>::solve_unchecked(const column_vector<long double>& b, long double relative_tolerance) const noexcept;
+} // agla::mtx
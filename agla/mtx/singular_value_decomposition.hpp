@@ -0,0 +1,49 @@
+#ifndef SINGULAR_VALUE_DECOMPOSITION_HPP
+#define SINGULAR_VALUE_DECOMPOSITION_HPP
+
+#include "column_vector.hpp"
+
+namespace agla::mtx {
+
+	// A = U * diag(sigma) * V^T by one-sided (Hestenes) Jacobi rotations of the columns of A.
+	// Accurate to high relative precision even for tiny singular values; best applied to the
+	// small R factor of a QR decomposition rather than to a tall A
+	template <numeric T> class singular_value_decomposition {
+
+		// Row j holds u_j and v_j; singular values are in descending order
+		matrix<T> left;
+		std::vector<T> values;
+		matrix<T> right;
+
+		singular_value_decomposition(matrix<T>&& left, std::vector<T>&& values, matrix<T>&& right) noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		// Returns nullopt for wide matrices
+		[[nodiscard]] static std::optional<singular_value_decomposition> from_matrix(const matrix<T>& a, std::size_t max_sweeps = 64) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t rows_number() const noexcept;
+		[[nodiscard]] inline std::size_t columns_number() const noexcept;
+
+		[[nodiscard]] inline const std::vector<T>& singular_values() const noexcept;
+
+		// ----------------------- Operations -----------------------
+
+		// sigma_max / sigma_min in the 2-norm; infinity for rank-deficient input
+		[[nodiscard]] inline T condition_number() const noexcept;
+
+		// Number of singular values above relative_tolerance * sigma_max
+		[[nodiscard]] inline std::size_t rank(T relative_tolerance) const noexcept;
+
+		// Minimum-norm argmin ||A * x - b||, dropping singular values below relative_tolerance * sigma_max.
+		// b has rows_number() elements; x is written to its first columns_number()
+		inline void solve_in_place(T* b, T relative_tolerance) const noexcept;
+		[[nodiscard]] inline column_vector<T> solve_unchecked(const column_vector<T>& b, T relative_tolerance) const noexcept;
+	};
+} // agla::mtx
+
+#endif // SINGULAR_VALUE_DECOMPOSITION_HPP
@@ -1,15 +1,20 @@
+#include <limits>
 #include <stdexcept>
 #include "square_matrix.hpp"
+#include "lu_decomposition.hpp"
+#include "cholesky_decomposition.hpp"
+#include "kernels.hpp"
+#include "../par/thread_pool.hpp"
 
 namespace agla::mtx {
 
 	// ----------------------- Constructors -----------------------
 
 	template <numeric T> square_matrix<T>::square_matrix(const matrix<T>& mtx) noexcept : matrix<T>(mtx) {}
-	template <numeric T> square_matrix<T>::square_matrix(matrix<T>&& mtx) noexcept : matrix<T>(mtx) {}
-	template <numeric T> square_matrix<T>::square_matrix(const std::size_t size) noexcept : matrix<T>(size) {}
-	template <numeric T> square_matrix<T>::square_matrix(const std::size_t size, const T& elem) noexcept : matrix<T>(size, std::vector<T>(size, elem)) {}
-	template <numeric T> square_matrix<T>::square_matrix(const std::size_t size, T&& elem) noexcept : matrix<T>(size, std::vector<T>(size, elem)) {}
+	template <numeric T> square_matrix<T>::square_matrix(matrix<T>&& mtx) noexcept : matrix<T>(std::move(mtx)) {}
+	template <numeric T> square_matrix<T>::square_matrix(const std::size_t size, const typename matrix<T>::allocator_type& allocator) noexcept : matrix<T>(size, allocator) {}
+	template <numeric T> square_matrix<T>::square_matrix(const std::size_t size, const T& elem, const typename matrix<T>::allocator_type& allocator) noexcept : matrix<T>(size, std::vector<T>(size, elem), allocator) {}
+	template <numeric T> square_matrix<T>::square_matrix(const std::size_t size, T&& elem, const typename matrix<T>::allocator_type& allocator) noexcept : matrix<T>(size, std::vector<T>(size, elem), allocator) {}
 	template <numeric T> square_matrix<T>::square_matrix(const std::vector<std::vector<T>>& mtx) noexcept : matrix<T>(mtx) {}
 	template <numeric T> square_matrix<T>::square_matrix(std::vector<std::vector<T>>&& mtx) noexcept : matrix<T>(mtx) {}
 
@@ -47,181 +52,89 @@ namespace agla::mtx {
 		return *this;
 	}
 
-	template <numeric T> [[nodiscard]] inline T square_matrix<T>::determinant() const noexcept {
-		auto copy = *this;
-		const auto size = copy.size();
-		T acc = 1;
-
-		for (std::size_t i = 0; i < size; ++i) {
-			auto diag = copy.get_unchecked(i).get_unchecked(i);
-			auto diag_index = i;
-
-			for (std::size_t q = i + 1; q < size; ++q) {
-				const auto cur_diag = copy.get_unchecked(q).get_unchecked(i);
-
-				if (std::abs(cur_diag) > std::abs(diag)) {
-					diag = cur_diag;
-					diag_index = q;
-				}
-			}
-
-			if (diag_index != i) {
-				std::swap(copy.get_unchecked(i), copy.get_unchecked(diag_index));
-				acc = -acc;
-			}
-
-			if (diag == 0)
-				return 0;
+	template <numeric T> inline void square_matrix<T>::transpose() noexcept {
+		const auto size = this->size();
 
-			for (std::size_t q = i + 1; q < size; ++q) {
-				const auto ratio = copy.get_unchecked(q).get_unchecked(i) / diag;
-				if (ratio == 0) continue;
+		AGLA_INSTRUMENT(transpose_in_place, size, size, 0, 2 * size * size * sizeof(T));
 
-				for (std::size_t k = 0; k < size; ++k)
-					copy.get_unchecked(q).get_unchecked(k) -=
-						copy.get_unchecked(i).get_unchecked(k) * ratio;
-			}
-		}
+		constexpr auto tile = kernels::transpose_tile;
+		std::vector<T*> rows(size);
 
 		for (std::size_t i = 0; i < size; ++i)
-			acc *= copy.get_unchecked(i).get_unchecked(i);
-
-		return acc;
-	}
+			rows[i] = this->get_unchecked(i).data();
 
-	template <numeric T> [[nodiscard]] inline square_matrix<T> square_matrix<T>::inversed_unchecked() const noexcept {
-		const auto size = this->size();
-		const auto aug_columns_num = 2 * size;
-		matrix<T> aug_mtx(size, std::vector<T>(aug_columns_num, 0));
+		// Each band of tile rows owns its diagonal tile and the tiles to its right
+		const auto bands = (size + tile - 1) / tile;
 
-		for (std::size_t i = 0; i < size; ++i) {
-			for (std::size_t q = 0; q < size; ++q)
-				aug_mtx.get_unchecked(i).get_unchecked(q) = this->get_unchecked(i).get_unchecked(q);
-			aug_mtx.get_unchecked(i).get_unchecked(i + size) = 1;
-		}
+		par::thread_pool::instance().parallel_for(0, bands, par::thread_pool::grain_for(tile * size), [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t band = from; band < to; ++band) {
+				const auto begin = band * tile;
+				const auto end = std::min(begin + tile, size);
 
-		for (std::size_t i = 0; i < size; ++i) {
-			auto diag = aug_mtx.get_unchecked(i).get_unchecked(i);
-			auto diag_index = i;
-
-			for (std::size_t q = i + 1; q < size; ++q) {
-				const auto cur_diag = aug_mtx.get_unchecked(q).get_unchecked(i);
-
-				if (std::abs(cur_diag) > std::abs(diag)) {
-					diag = cur_diag;
-					diag_index = q;
-				}
+				kernels::transpose_in_place(rows.data(), begin, end);
+				kernels::swap_transposed(rows.data(), begin, end, end, size);
 			}
+		});
+	}
 
-			if (diag_index != i)
-				std::swap(aug_mtx.get_unchecked(i), aug_mtx.get_unchecked(diag_index));
-
-			for (std::size_t q = i + 1; q < size; ++q) {
-				const auto ratio = aug_mtx.get_unchecked(q).get_unchecked(i) / diag;
-				if (ratio == 0) continue;
-
-				for (std::size_t k = 0; k < aug_columns_num; ++k)
-					aug_mtx.get_unchecked(q).get_unchecked(k) -=
-						aug_mtx.get_unchecked(i).get_unchecked(k) * ratio;
-			}
-		}
+	template <numeric T> [[nodiscard]] inline T square_matrix<T>::determinant() const noexcept {
+		auto copy = *this;
+		std::vector<std::size_t> pivots;
 
-		for (int i = size - 1; i >= 0; --i) {
-			const auto diag = aug_mtx.get_unchecked(i).get_unchecked(i);
+		if (!lu_decomposition<T>::factorize_in_place(copy, pivots))
+			return 0;
 
-			for (int q = i - 1; q >= 0; --q) {
-				const auto ratio = aug_mtx.get_unchecked(q).get_unchecked(i) / diag;
-				if (ratio == 0) continue;
+		T acc = 1;
 
-				for (std::size_t k = i; k < aug_columns_num; ++k)
-					aug_mtx.get_unchecked(q).get_unchecked(k) -=
-						aug_mtx.get_unchecked(i).get_unchecked(k) * ratio;
-			}
-		}
+		for (std::size_t i = 0; i < copy.size(); ++i) {
+			acc *= copy.get_unchecked(i).get_unchecked(i);
 
-		for (std::size_t i = 0; i < size; ++i) {
-			for (std::size_t q = size; q < aug_columns_num; ++q)
-				aug_mtx.get_unchecked(i).get_unchecked(q) /=
-					aug_mtx.get_unchecked(i).get_unchecked(i);
-			aug_mtx.get_unchecked(i).get_unchecked(i) = 1;
+			if (pivots[i] != i)
+				acc = -acc;
 		}
 
-		square_matrix<T> result(size);
-
-		for (std::size_t i = 0; i < size; ++i)
-			for (std::size_t q = 0, qg = size; q < size; ++q, ++qg)
-				result.get_unchecked(i).get_unchecked(q) =
-					aug_mtx.get_unchecked(i).get_unchecked(qg);
-
-		return std::move(result);
+		return acc;
 	}
 
-	template <numeric T> [[nodiscard]] inline std::optional<square_matrix<T>> square_matrix<T>::inversed() const noexcept {
-		const auto size = this->size();
-		const auto aug_columns_num = 2 * size;
-		matrix<T> aug_mtx(size, std::vector<T>(aug_columns_num, 0));
-
-		for (std::size_t i = 0; i < size; ++i) {
-			for (std::size_t q = 0; q < size; ++q)
-				aug_mtx.get_unchecked(i).get_unchecked(q) = this->get_unchecked(i).get_unchecked(q);
-			aug_mtx.get_unchecked(i).get_unchecked(i + size) = 1;
-		}
-
-		for (std::size_t i = 0; i < size; ++i) {
-			auto diag = aug_mtx.get_unchecked(i).get_unchecked(i);
-			auto diag_index = i;
-
-			for (std::size_t q = i + 1; q < size; ++q) {
-				const auto cur_diag = aug_mtx.get_unchecked(q).get_unchecked(i);
-
-				if (std::abs(cur_diag) > std::abs(diag)) {
-					diag = cur_diag;
-					diag_index = q;
-				}
-			}
+	template <numeric T> [[nodiscard]] inline signed_log_determinant<T> square_matrix<T>::log_abs_determinant() const noexcept {
+		auto copy = *this;
+		std::vector<std::size_t> pivots;
 
-			if (diag_index != i)
-				std::swap(aug_mtx.get_unchecked(i), aug_mtx.get_unchecked(diag_index));
+		if (!lu_decomposition<T>::factorize_in_place(copy, pivots))
+			return { T(0), -std::numeric_limits<T>::infinity() };
 
-			if (diag == 0)
-				return std::nullopt;
+		return lu_decomposition<T>::log_abs_determinant(copy, pivots);
+	}
 
-			for (std::size_t q = i + 1; q < size; ++q) {
-				const auto ratio = aug_mtx.get_unchecked(q).get_unchecked(i) / diag;
-				if (ratio == 0) continue;
+	template <numeric T> [[nodiscard]] inline bool square_matrix<T>::invert() noexcept {
+		std::vector<std::size_t> pivots;
 
-				for (std::size_t k = 0; k < aug_columns_num; ++k)
-					aug_mtx.get_unchecked(q).get_unchecked(k) -=
-						aug_mtx.get_unchecked(i).get_unchecked(k) * ratio;
-			}
-		}
+		if (!lu_decomposition<T>::factorize_in_place(*this, pivots))
+			return false;
 
-		for (int i = size - 1; i >= 0; --i) {
-			const auto diag = aug_mtx.get_unchecked(i).get_unchecked(i);
+		lu_decomposition<T>::invert_in_place(*this, pivots);
+		return true;
+	}
 
-			for (int q = i - 1; q >= 0; --q) {
-				const auto ratio = aug_mtx.get_unchecked(q).get_unchecked(i) / diag;
-				if (ratio == 0) continue;
+	template <numeric T> [[nodiscard]] inline bool square_matrix<T>::invert_positive_definite() noexcept {
+		if (!cholesky_decomposition<T>::factorize_in_place(*this))
+			return false;
 
-				for (std::size_t k = i; k < aug_columns_num; ++k)
-					aug_mtx.get_unchecked(q).get_unchecked(k) -=
-						aug_mtx.get_unchecked(i).get_unchecked(k) * ratio;
-			}
-		}
+		cholesky_decomposition<T>::invert_in_place(*this);
+		return true;
+	}
 
-		for (std::size_t i = 0; i < size; ++i) {
-			for (std::size_t q = size; q < aug_columns_num; ++q)
-				aug_mtx.get_unchecked(i).get_unchecked(q) /=
-					aug_mtx.get_unchecked(i).get_unchecked(i);
-			aug_mtx.get_unchecked(i).get_unchecked(i) = 1;
-		}
+	template <numeric T> [[nodiscard]] inline square_matrix<T> square_matrix<T>::inversed_unchecked() const noexcept {
+		auto result = *this;
+		static_cast<void>(result.invert());
+		return result;
+	}
 
-		square_matrix<T> result(size);
+	template <numeric T> [[nodiscard]] inline std::optional<square_matrix<T>> square_matrix<T>::inversed() const noexcept {
+		auto result = *this;
 
-		for (std::size_t i = 0; i < size; ++i)
-			for (std::size_t q = 0, qg = size; q < size; ++q, ++qg)
-				result.get_unchecked(i).get_unchecked(q) =
-					aug_mtx.get_unchecked(i).get_unchecked(qg);
+		if (!result.invert())
+			return std::nullopt;
 
 		return { std::move(result) };
 	}
@@ -230,9 +143,9 @@ namespace agla::mtx {
 
 	template square_matrix<double>::square_matrix(const matrix<double>& mtx) noexcept;
 	template square_matrix<double>::square_matrix(matrix<double>&& mtx) noexcept;
-	template square_matrix<double>::square_matrix(std::size_t size) noexcept;
-	template square_matrix<double>::square_matrix(std::size_t size, const double& elem) noexcept;
-	template square_matrix<double>::square_matrix(std::size_t size, double&& elem) noexcept;
+	template square_matrix<double>::square_matrix(std::size_t size, const matrix<double>::allocator_type& allocator) noexcept;
+	template square_matrix<double>::square_matrix(std::size_t size, const double& elem, const matrix<double>::allocator_type& allocator) noexcept;
+	template square_matrix<double>::square_matrix(std::size_t size, double&& elem, const matrix<double>::allocator_type& allocator) noexcept;
 	template square_matrix<double>::square_matrix(const std::vector<std::vector<double>>& mtx) noexcept;
 	template square_matrix<double>::square_matrix(std::vector<std::vector<double>>&& mtx) noexcept;
 	template square_matrix<double>::square_matrix(std::size_t rows, const std::vector<double>& row) noexcept;
@@ -248,7 +161,74 @@ namespace agla::mtx {
 	template std::optional<square_matrix<double>> square_matrix<double>::operator-(const square_matrix& other) const noexcept;
 	template square_matrix<double>& square_matrix<double>::operator=(const square_matrix<double>& matrix) noexcept;
 
+	template void square_matrix<double>::transpose() noexcept;
+
 	template double square_matrix<double>::determinant() const noexcept;
+	template signed_log_determinant<double> square_matrix<double>::log_abs_determinant() const noexcept;
+	template bool square_matrix<double>::invert() noexcept;
+	template bool square_matrix<double>::invert_positive_definite() noexcept;
 	template square_matrix<double> square_matrix<double>::inversed_unchecked() const noexcept;
 	template std::optional<square_matrix<double>> square_matrix<double>::inversed() const noexcept;
+
+	// ----------------------- Constructors -----------------------
+
+	template square_matrix<float>::square_matrix(const matrix<float>& mtx) noexcept;
+	template square_matrix<float>::square_matrix(matrix<float>&& mtx) noexcept;
+	template square_matrix<float>::square_matrix(std::size_t size, const matrix<float>::allocator_type& allocator) noexcept;
+	template square_matrix<float>::square_matrix(std::size_t size, const float& elem, const matrix<float>::allocator_type& allocator) noexcept;
+	template square_matrix<float>::square_matrix(std::size_t size, float&& elem, const matrix<float>::allocator_type& allocator) noexcept;
+	template square_matrix<float>::square_matrix(const std::vector<std::vector<float>>& mtx) noexcept;
+	template square_matrix<float>::square_matrix(std::vector<std::vector<float>>&& mtx) noexcept;
+	template square_matrix<float>::square_matrix(std::size_t rows, const std::vector<float>& row) noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template std::size_t square_matrix<float>::size() const noexcept;
+
+	template square_matrix<float> square_matrix<float>::add_unchecked(const square_matrix& other) const noexcept;
+	template square_matrix<float> square_matrix<float>::sub_unchecked(const square_matrix& other) const noexcept;
+
+	template std::optional<square_matrix<float>> square_matrix<float>::operator+(const square_matrix& other) const noexcept;
+	template std::optional<square_matrix<float>> square_matrix<float>::operator-(const square_matrix& other) const noexcept;
+	template square_matrix<float>& square_matrix<float>::operator=(const square_matrix<float>& matrix) noexcept;
+
+	template void square_matrix<float>::transpose() noexcept;
+
+	template float square_matrix<float>::determinant() const noexcept;
+	template signed_log_determinant<float> square_matrix<float>::log_abs_determinant() const noexcept;
+	template bool square_matrix<float>::invert() noexcept;
+	template bool square_matrix<float>::invert_positive_definite() noexcept;
+	template square_matrix<float> square_matrix<float>::inversed_unchecked() const noexcept;
+	template std::optional<square_matrix<float>> square_matrix<float>::inversed() const noexcept;
+
+	// ----------------------- Constructors -----------------------
+
+	template square_matrix<long double>::square_matrix(const matrix<long double>& mtx) noexcept;
+	template square_matrix<long double>::square_matrix(matrix<long double>&& mtx) noexcept;
+	template square_matrix<long double>::square_matrix(std::size_t size, const matrix<long double>::allocator_type& allocator) noexcept;
+	template square_matrix<long double>::square_matrix(std::size_t size, const long double& elem, const matrix<long double>::allocator_type& allocator) noexcept;
+	template square_matrix<long double>::square_matrix(std::size_t size, long double&& elem, const matrix<long double>::allocator_type& allocator) noexcept;
+	template square_matrix<long double>::square_matrix(const std::vector<std::vector<long double>>& mtx) noexcept;
+	template square_matrix<long double>::square_matrix(std::vector<std::vector<long double>>&& mtx) noexcept;
+	template square_matrix<long double>::square_matrix(std::size_t rows, const std::vector<long double>& row) noexcept;
+
+	// ----------------------- Operations -----------------------
+
+	template std::size_t square_matrix<long double>::size() const noexcept;
+
+	template square_matrix<long double> square_matrix<long double>::add_unchecked(const square_matrix& other) const noexcept;
+	template square_matrix<long double> square_matrix<long double>::sub_unchecked(const square_matrix& other) const noexcept;
+
+	template std::optional<square_matrix<long double>> square_matrix<long double>::operator+(const square_matrix& other) const noexcept;
+	template std::optional<square_matrix<long double>> square_matrix<long double>::operator-(const square_matrix& other) const noexcept;
+	template square_matrix<long double>& square_matrix<long double>::operator=(const square_matrix<long double>& matrix) noexcept;
+
+	template void square_matrix<long double>::transpose() noexcept;
+
+	template long double square_matrix<long double>::determinant() const noexcept;
+	template signed_log_determinant<long double> square_matrix<long double>::log_abs_determinant() const noexcept;
+	template bool square_matrix<long double>::invert() noexcept;
+	template bool square_matrix<long double>::invert_positive_definite() noexcept;
+	template square_matrix<long double> square_matrix<long double>::inversed_unchecked() const noexcept;
+	template std::optional<square_matrix<long double>> square_matrix<long double>::inversed() const noexcept;
 } // agla::mtx
\ No newline at end of file
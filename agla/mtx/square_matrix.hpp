@@ -4,6 +4,13 @@
 #include "matrix.hpp"
 
 namespace agla::mtx {
+
+	// det = sign * exp(log_abs_value); sign is 0 and log_abs_value is -inf for singular input
+	template <numeric T> struct signed_log_determinant {
+		T sign;
+		T log_abs_value;
+	};
+
 	template <numeric T> class square_matrix : public matrix<T> {
 		explicit square_matrix(const matrix<T>& mtx) noexcept;
 		explicit square_matrix(matrix<T>&& mtx) noexcept;
@@ -12,10 +19,10 @@ namespace agla::mtx {
 
 		// ----------------------- Constructors -----------------------
 
-		explicit square_matrix(std::size_t size) noexcept;
+		explicit square_matrix(std::size_t size, const typename matrix<T>::allocator_type& allocator = {}) noexcept;
 
-		square_matrix(std::size_t size, const T& elem) noexcept;
-		square_matrix(std::size_t size, T&& elem) noexcept;
+		square_matrix(std::size_t size, const T& elem, const typename matrix<T>::allocator_type& allocator = {}) noexcept;
+		square_matrix(std::size_t size, T&& elem, const typename matrix<T>::allocator_type& allocator = {}) noexcept;
 
 		square_matrix(std::size_t rows, const std::vector<T>& row) noexcept;
 
@@ -55,7 +62,16 @@ namespace agla::mtx {
 		[[nodiscard]] inline std::optional<square_matrix> operator-(const square_matrix& other) const noexcept;
 		inline square_matrix& operator=(const square_matrix& matrix) noexcept;
 
+		inline void transpose() noexcept;
+
 		[[nodiscard]] inline T determinant() const noexcept;
+		[[nodiscard]] inline signed_log_determinant<T> log_abs_determinant() const noexcept;
+
+		// In-place inversion through LU (or Cholesky for SPD input), O(n) extra memory.
+		// Return false on singular (non-positive definite) input, leaving *this unspecified
+		[[nodiscard]] inline bool invert() noexcept;
+		[[nodiscard]] inline bool invert_positive_definite() noexcept;
+
 		[[nodiscard]] inline square_matrix inversed_unchecked() const noexcept;
 		[[nodiscard]] inline std::optional<square_matrix<T>> inversed() const noexcept;
 	};
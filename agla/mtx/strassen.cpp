@@ -0,0 +1,247 @@
+#include <cmath>
+
+#include "strassen.hpp"
+#include "aligned_resource.hpp"
+#include "instrumentation.hpp"
+#include "kernels.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::mtx {
+	namespace {
+
+		// Square block of a row-major buffer
+		template <typename T> struct block {
+			T* data;
+			std::size_t stride;
+
+			[[nodiscard]] inline T* row(const std::size_t i) const noexcept { return data + i * stride; }
+
+			[[nodiscard]] inline block quadrant(const std::size_t r, const std::size_t c, const std::size_t half) const noexcept {
+				return { data + r * half * stride + c * half, stride };
+			}
+		};
+
+		// out(i, j) = value(i, j) over a size x size block, row by row
+		template <numeric T, typename Value> void fill(const block<T> out, const std::size_t size, Value&& value) noexcept {
+			for (std::size_t i = 0; i < size; ++i) {
+				auto* const out_row = out.row(i);
+
+				for (std::size_t j = 0; j < size; ++j)
+					out_row[j] = value(i, j);
+			}
+		}
+
+		// The kernel of matrix::mul_unchecked on blocks
+		template <numeric T> void classical(const block<const T> a, const block<const T> b, const block<T> c, const std::size_t size) noexcept {
+			for (std::size_t i = 0; i < size; ++i) {
+				const auto* const a_row = a.row(i);
+				auto* const c_row = c.row(i);
+
+				std::fill_n(c_row, size, T(0));
+
+				for (std::size_t k = 0; k < size; ++k)
+					kernels::axpy(a_row[k], b.row(k), c_row, size);
+			}
+		}
+
+		template <numeric T> void multiply(const block<const T> a, const block<const T> b, const block<T> c, const std::size_t size, const std::size_t levels) noexcept {
+			if (levels == 0) {
+				classical(a, b, c, size);
+				return;
+			}
+
+			const auto h = size / 2;
+			const auto a11 = a.quadrant(0, 0, h), a12 = a.quadrant(0, 1, h), a21 = a.quadrant(1, 0, h), a22 = a.quadrant(1, 1, h);
+			const auto b11 = b.quadrant(0, 0, h), b12 = b.quadrant(0, 1, h), b21 = b.quadrant(1, 0, h), b22 = b.quadrant(1, 1, h);
+
+			// ----------------------- Products -----------------------
+
+			// Each task forms its own operands, so the seven products share no scratch:
+			// S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2 and
+			// T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21.
+			// Scratch is line-aligned, so the products and operands of separate tasks never share a line
+			std::pmr::vector<T> products(7 * h * h, aligned_resource::instance());
+			const auto product = [&](const std::size_t k) { return block<T> { products.data() + k * h * h, h }; };
+
+			par::thread_pool::instance().parallel_for(0, 7, 1, [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t k = from; k < to; ++k) {
+					std::pmr::vector<T> operands(k < 2 ? 0 : 2 * h * h, aligned_resource::instance());
+					const block<T> s { operands.data(), h };
+					const block<T> t { operands.data() + h * h, h };
+
+					switch (k) {
+						case 0: // P1 = A11 * B11
+							multiply<T>(a11, b11, product(0), h, levels - 1);
+							break;
+						case 1: // P2 = A12 * B21
+							multiply<T>(a12, b21, product(1), h, levels - 1);
+							break;
+						case 2: // P3 = S4 * B22
+							fill<T>(s, h, [&](auto i, auto j) { return a12.row(i)[j] - ((a21.row(i)[j] + a22.row(i)[j]) - a11.row(i)[j]); });
+							multiply<T>({ s.data, h }, b22, product(2), h, levels - 1);
+							break;
+						case 3: // P4 = A22 * T4
+							fill<T>(t, h, [&](auto i, auto j) { return (b22.row(i)[j] - (b12.row(i)[j] - b11.row(i)[j])) - b21.row(i)[j]; });
+							multiply<T>(a22, { t.data, h }, product(3), h, levels - 1);
+							break;
+						case 4: // P5 = S1 * T1
+							fill<T>(s, h, [&](auto i, auto j) { return a21.row(i)[j] + a22.row(i)[j]; });
+							fill<T>(t, h, [&](auto i, auto j) { return b12.row(i)[j] - b11.row(i)[j]; });
+							multiply<T>({ s.data, h }, { t.data, h }, product(4), h, levels - 1);
+							break;
+						case 5: // P6 = S2 * T2
+							fill<T>(s, h, [&](auto i, auto j) { return (a21.row(i)[j] + a22.row(i)[j]) - a11.row(i)[j]; });
+							fill<T>(t, h, [&](auto i, auto j) { return b22.row(i)[j] - (b12.row(i)[j] - b11.row(i)[j]); });
+							multiply<T>({ s.data, h }, { t.data, h }, product(5), h, levels - 1);
+							break;
+						default: // P7 = S3 * T3
+							fill<T>(s, h, [&](auto i, auto j) { return a11.row(i)[j] - a21.row(i)[j]; });
+							fill<T>(t, h, [&](auto i, auto j) { return b22.row(i)[j] - b12.row(i)[j]; });
+							multiply<T>({ s.data, h }, { t.data, h }, product(6), h, levels - 1);
+							break;
+					}
+				}
+			});
+
+			// ----------------------- Combination -----------------------
+
+			// U2 = P1 + P6, U3 = U2 + P7, U4 = U2 + P5 and
+			// C11 = P1 + P2, C12 = U4 + P3, C21 = U3 - P4, C22 = U3 + P5
+			par::thread_pool::instance().parallel_for(0, h, par::thread_pool::grain_for(7 * h), [&](const std::size_t from, const std::size_t to) {
+				for (std::size_t i = from; i < to; ++i) {
+					const auto* const p1 = product(0).row(i);
+					const auto* const p2 = product(1).row(i);
+					const auto* const p3 = product(2).row(i);
+					const auto* const p4 = product(3).row(i);
+					const auto* const p5 = product(4).row(i);
+					const auto* const p6 = product(5).row(i);
+					const auto* const p7 = product(6).row(i);
+
+					auto* const c11 = c.quadrant(0, 0, h).row(i);
+					auto* const c12 = c.quadrant(0, 1, h).row(i);
+					auto* const c21 = c.quadrant(1, 0, h).row(i);
+					auto* const c22 = c.quadrant(1, 1, h).row(i);
+
+					for (std::size_t j = 0; j < h; ++j) {
+						const auto u2 = p1[j] + p6[j];
+						const auto u3 = u2 + p7[j];
+
+						c11[j] = p1[j] + p2[j];
+						c12[j] = (u2 + p5[j]) + p3[j];
+						c21[j] = u3 - p4[j];
+						c22[j] = u3 + p5[j];
+					}
+				}
+			});
+		}
+
+		template <numeric T> [[nodiscard]] T max_magnitude(const square_matrix<T>& m) noexcept {
+			T result = 0;
+
+			for (std::size_t i = 0; i < m.size(); ++i)
+				for (std::size_t j = 0; j < m.size(); ++j)
+					result = std::max(result, std::abs(m.get_unchecked(i).get_unchecked(j)));
+
+			return result;
+		}
+	}
+
+	template <numeric T> [[nodiscard]] strassen_product<T> strassen_mul_unchecked(
+		const square_matrix<T>& a,
+		const square_matrix<T>& b,
+		const strassen_options& options
+	) noexcept {
+		const auto n = a.size();
+		const auto crossover = std::max<std::size_t>(options.crossover, 1);
+
+		std::size_t levels = 0;
+
+		while ((n + (std::size_t(1) << levels) - 1) >> levels > crossover)
+			++levels;
+
+		const auto base = (n + (std::size_t(1) << levels) - 1) >> levels;
+		const auto padded = base << levels;
+
+		// Higham, Accuracy and Stability of Numerical Algorithms, theorem 23.3, in the max norm
+		const auto unit = std::numeric_limits<T>::epsilon() / 2;
+		const auto scale = unit * max_magnitude(a) * max_magnitude(b);
+		const auto growth = std::pow(T(18), static_cast<T>(levels)) * static_cast<T>(base * base + 6 * base) - T(6 * padded);
+
+		std::uint64_t flops = 2 * base * base * base;
+
+		for (std::size_t level = 0; level < levels; ++level)
+			flops = 7 * flops + 15 * (base << level) * (base << level);
+
+		AGLA_INSTRUMENT(mul_strassen, n, n, flops, 3 * n * n * sizeof(T));
+
+		if (levels == 0)
+			return { square_matrix<T>::from_matrix_unchecked(a.mul_unchecked(b)), 0, static_cast<T>(n * n) * scale, static_cast<T>(n * n) * scale };
+
+		// ----------------------- Padding -----------------------
+
+		std::pmr::vector<T> a_padded(padded * padded, T(0), aligned_resource::instance());
+		std::pmr::vector<T> b_padded(padded * padded, T(0), aligned_resource::instance());
+		std::pmr::vector<T> c_padded(padded * padded, aligned_resource::instance());
+
+		for (std::size_t i = 0; i < n; ++i) {
+			std::copy_n(a.get_unchecked(i).data(), n, a_padded.data() + i * padded);
+			std::copy_n(b.get_unchecked(i).data(), n, b_padded.data() + i * padded);
+		}
+
+		multiply<T>({ a_padded.data(), padded }, { b_padded.data(), padded }, { c_padded.data(), padded }, padded, levels);
+
+		square_matrix<T> product(n, a.get_allocator());
+
+		for (std::size_t i = 0; i < n; ++i)
+			std::copy_n(c_padded.data() + i * padded, n, product.get_unchecked(i).data());
+
+		return { std::move(product), levels, growth * scale, static_cast<T>(n * n) * scale };
+	}
+
+	template <numeric T> [[nodiscard]] std::optional<strassen_product<T>> strassen_mul(
+		const square_matrix<T>& a,
+		const square_matrix<T>& b,
+		const strassen_options& options
+	) noexcept {
+		if (a.size() != b.size())
+			return std::nullopt;
+
+		return std::make_optional(strassen_mul_unchecked(a, b, options));
+	}
+
+	template strassen_product<double> strassen_mul_unchecked(
+		const square_matrix<double>& a,
+		const square_matrix<double>& b,
+		const strassen_options& options
+	) noexcept;
+
+	template std::optional<strassen_product<double>> strassen_mul(
+		const square_matrix<double>& a,
+		const square_matrix<double>& b,
+		const strassen_options& options
+	) noexcept;
+
+	template strassen_product<float> strassen_mul_unchecked(
+		const square_matrix<float>& a,
+		const square_matrix<float>& b,
+		const strassen_options& options
+	) noexcept;
+
+	template std::optional<strassen_product<float>> strassen_mul(
+		const square_matrix<float>& a,
+		const square_matrix<float>& b,
+		const strassen_options& options
+	) noexcept;
+
+	template strassen_product<long double> strassen_mul_unchecked(
+		const square_matrix<long double>& a,
+		const square_matrix<long double>& b,
+		const strassen_options& options
+	) noexcept;
+
+	template std::optional<strassen_product<long double>> strassen_mul(
+		const square_matrix<long double>& a,
+		const square_matrix<long double>& b,
+		const strassen_options& options
+	) noexcept;
+} // agla::mtx
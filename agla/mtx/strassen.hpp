@@ -0,0 +1,41 @@
+#ifndef STRASSEN_HPP
+#define STRASSEN_HPP
+
+#include "square_matrix.hpp"
+
+namespace agla::mtx {
+
+	struct strassen_options {
+
+		// Blocks of at most this size go to the classical row-axpy kernel. The input is padded
+		// with zeros once, to base * 2^levels with base <= crossover, so odd sizes need no peeling
+		std::size_t crossover = 256;
+	};
+
+	template <numeric T> struct strassen_product {
+		square_matrix<T> product;
+		std::size_t levels;
+
+		// Higham's first-order bounds on max |C - fl(C)| for the Winograd variant and for the
+		// classical product; their ratio is the price paid in accuracy for the speedup
+		T error_bound;
+		T classical_bound;
+	};
+
+	// Strassen-Winograd: 7 products and 15 additions per level, O(n^2.81). The 7 sub-products
+	// of every level run as pool tasks; the result does not depend on the thread count
+	template <numeric T> [[nodiscard]] strassen_product<T> strassen_mul_unchecked(
+		const square_matrix<T>& a,
+		const square_matrix<T>& b,
+		const strassen_options& options = {}
+	) noexcept;
+
+	// Nullopt when the sizes differ
+	template <numeric T> [[nodiscard]] std::optional<strassen_product<T>> strassen_mul(
+		const square_matrix<T>& a,
+		const square_matrix<T>& b,
+		const strassen_options& options = {}
+	) noexcept;
+} // agla::mtx
+
+#endif // STRASSEN_HPP
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include "thread_pool.hpp"
+
+namespace agla::par {
+	namespace {
+		thread_local const thread_pool* current_pool = nullptr;
+		thread_local std::size_t current_index = 0;
+
+		std::unique_ptr<thread_pool>& shared_pool() noexcept {
+			static std::unique_ptr<thread_pool> pool;
+			return pool;
+		}
+
+		std::size_t default_workers() noexcept {
+			if (const auto* const env = std::getenv("AGLA_NUM_THREADS")) {
+				const auto workers = std::strtoul(env, nullptr, 10);
+				if (workers > 0) return workers;
+			}
+
+			return std::max(1U, std::thread::hardware_concurrency());
+		}
+
+		void pin_current_thread(const std::size_t core) noexcept {
+#ifdef __linux__
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(core % std::max(1U, std::thread::hardware_concurrency()), &set);
+			pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+			(void) core;
+#endif
+		}
+	}
+
+	// ----------------------- Constructors -----------------------
+
+	thread_pool::thread_pool(const std::size_t workers, const bool pin_to_cores) noexcept {
+		const auto total = std::max<std::size_t>(workers, 1);
+
+		for (std::size_t i = 0; i < total; ++i)
+			queues.push_back(std::make_unique<task_queue>());
+
+		for (std::size_t i = 1; i < total; ++i)
+			threads.emplace_back([this, i, pin_to_cores] {
+				if (pin_to_cores) pin_current_thread(i);
+				worker_loop(i);
+			});
+	}
+
+	thread_pool::~thread_pool() noexcept {
+		{
+			std::lock_guard lock(sleep_mutex);
+			stopping.store(true);
+		}
+
+		sleep_condition.notify_all();
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	thread_pool& thread_pool::instance() noexcept {
+		static std::once_flag initialized;
+
+		std::call_once(initialized, [] {
+			if (!shared_pool())
+				shared_pool() = std::make_unique<thread_pool>(default_workers());
+		});
+
+		return *shared_pool();
+	}
+
+	void thread_pool::configure(const std::size_t workers, const bool pin_to_cores) noexcept {
+		static_cast<void>(instance());
+		shared_pool() = std::make_unique<thread_pool>(workers, pin_to_cores);
+	}
+
+	// ----------------------- Scheduling -----------------------
+
+	void thread_pool::worker_loop(const std::size_t index) noexcept {
+		current_pool = this;
+		current_index = index;
+
+		while (!stopping.load()) {
+			if (auto* const t = find_task(index)) {
+				t->run(t);
+				t->done.store(true, std::memory_order_release);
+				continue;
+			}
+
+			std::unique_lock lock(sleep_mutex);
+			sleep_condition.wait(lock, [this] { return queued.load() > 0 || stopping.load(); });
+		}
+	}
+
+	[[nodiscard]] std::size_t thread_pool::current_queue() const noexcept {
+		return current_pool == this ? current_index : 0;
+	}
+
+	[[nodiscard]] thread_pool::task* thread_pool::find_task(const std::size_t index) noexcept {
+		if (queued.load() == 0)
+			return nullptr;
+
+		{
+			auto& own = *queues[index];
+			std::lock_guard lock(own.mutex);
+
+			if (!own.tasks.empty()) {
+				auto* const t = own.tasks.back();
+				own.tasks.pop_back();
+				queued.fetch_sub(1);
+				return t;
+			}
+		}
+
+		for (std::size_t shift = 1; shift < queues.size(); ++shift) {
+			auto& victim = *queues[(index + shift) % queues.size()];
+			std::lock_guard lock(victim.mutex);
+
+			if (!victim.tasks.empty()) {
+				auto* const t = victim.tasks.front();
+				victim.tasks.pop_front();
+				queued.fetch_sub(1);
+				return t;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void thread_pool::push(const std::size_t index, task* const t) noexcept {
+		{
+			auto& queue = *queues[index];
+			std::lock_guard lock(queue.mutex);
+			queue.tasks.push_back(t);
+		}
+
+		{
+			std::lock_guard lock(sleep_mutex);
+			queued.fetch_add(1);
+		}
+
+		sleep_condition.notify_one();
+	}
+
+	void thread_pool::wait_for(const task& t) noexcept {
+		const auto index = current_queue();
+
+		while (!t.done.load(std::memory_order_acquire)) {
+			if (auto* const other = find_task(index)) {
+				other->run(other);
+				other->done.store(true, std::memory_order_release);
+				continue;
+			}
+
+			std::this_thread::yield();
+		}
+	}
+} // agla::par
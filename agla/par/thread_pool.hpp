@@ -0,0 +1,124 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace agla::par {
+	class thread_pool {
+
+		// ########################## Task ##########################
+
+		struct task {
+			void (*run)(task*) noexcept;
+			std::atomic<bool> done { false };
+		};
+
+		template <typename F> struct function_task : task {
+			F& function;
+
+			explicit function_task(F& function) noexcept : task { &invoke }, function(function) {}
+
+			static void invoke(task* const self) noexcept {
+				static_cast<function_task*>(self)->function();
+			}
+		};
+
+		struct task_queue {
+			std::mutex mutex;
+			std::deque<task*> tasks;
+		};
+
+		// Queue 0 is shared by threads that do not belong to the pool
+		std::vector<std::unique_ptr<task_queue>> queues;
+		std::vector<std::thread> threads;
+
+		std::atomic<std::size_t> queued { 0 };
+		std::atomic<bool> stopping { false };
+
+		std::mutex sleep_mutex;
+		std::condition_variable sleep_condition;
+
+		void worker_loop(std::size_t index) noexcept;
+
+		[[nodiscard]] std::size_t current_queue() const noexcept;
+		[[nodiscard]] task* find_task(std::size_t index) noexcept;
+
+		void push(std::size_t index, task* t) noexcept;
+		void wait_for(const task& t) noexcept;
+
+	 public:
+
+		// ----------------------- Constructors -----------------------
+
+		// workers counts the calling thread, so workers - 1 threads are spawned
+		explicit thread_pool(std::size_t workers, bool pin_to_cores = false) noexcept;
+		~thread_pool() noexcept;
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		// Shared pool used by agla kernels, sized by AGLA_NUM_THREADS or the hardware
+		[[nodiscard]] static thread_pool& instance() noexcept;
+
+		// Replaces the shared pool; must not race with running kernels
+		static void configure(std::size_t workers, bool pin_to_cores = false) noexcept;
+
+		// ----------------------- Accessors -----------------------
+
+		[[nodiscard]] inline std::size_t workers_number() const noexcept { return threads.size() + 1; }
+
+		// Smallest number of items whose total work is worth a task of its own
+		[[nodiscard]] static inline std::size_t grain_for(const std::size_t work_per_item) noexcept {
+			constexpr std::size_t min_parallel_work = 1 << 15;
+			return std::max<std::size_t>(1, min_parallel_work / std::max<std::size_t>(1, work_per_item));
+		}
+
+		// ----------------------- Operations -----------------------
+
+		template <typename F1, typename F2> inline void fork_join(F1&& first, F2&& second) noexcept {
+			if (threads.empty()) {
+				first();
+				second();
+				return;
+			}
+
+			function_task<std::remove_reference_t<F2>> second_task(second);
+			push(current_queue(), &second_task);
+			first();
+			wait_for(second_task);
+		}
+
+		template <typename F> inline void parallel_for(
+			const std::size_t begin,
+			const std::size_t end,
+			const std::size_t grain,
+			F&& body
+		) noexcept {
+			if (end <= begin)
+				return;
+
+			if (end - begin <= std::max<std::size_t>(grain, 1) || threads.empty()) {
+				body(begin, end);
+				return;
+			}
+
+			const auto middle = begin + (end - begin) / 2;
+
+			fork_join(
+				[&] { parallel_for(begin, middle, grain, body); },
+				[&] { parallel_for(middle, end, grain, body); }
+			);
+		}
+	};
+} // agla::par
+
+#endif // THREAD_POOL_HPP
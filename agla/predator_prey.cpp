@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "predator_prey.hpp"
+#include "par/thread_pool.hpp"
+
+namespace predator_prey {
+	namespace {
+
+		// Samples per block: the sin/cos scratch and the angle table stay in L1
+		constexpr std::size_t block = 256;
+
+		template <std::floating_point T> void write_block(
+			const model<T>& m,
+			const T* __restrict__ sin,
+			const T* __restrict__ cos,
+			const std::size_t offset,
+			const std::size_t size,
+			const trajectories<T>& out
+		) noexcept {
+			// One loop per requested output, so none of them branches per sample
+			const auto fill = [&](T* const dst, const T sin_coefficient, const T cos_coefficient, const T offset_value) {
+				if (dst == nullptr)
+					return;
+
+				for (std::size_t i = 0; i < size; ++i)
+					dst[offset + i] = sin_coefficient * sin[i] + cos_coefficient * cos[i] + offset_value;
+			};
+
+			fill(out.k, m.k_sin, m.k_cos, T(0));
+			fill(out.K, m.k_sin, m.k_cos, m.k_offset);
+			fill(out.v, m.v_sin, m.v_cos, T(0));
+			fill(out.V, m.v_sin, m.v_cos, m.v_offset);
+		}
+
+		// Scenarios per batch; every per-step loop runs across them
+		constexpr std::size_t lanes = 8;
+		constexpr std::size_t components = 2;
+		constexpr std::size_t stages = 7;
+
+		// Dormand-Prince 5(4): a[i] holds the stage i coefficients, stage 7 is the 5th-order solution
+		// evaluated again at the start of the next step (FSAL); e estimates the local error and d
+		// completes Hairer's continuous extension
+		template <std::floating_point T> struct dormand_prince {
+			static constexpr T a[stages][stages - 1] = {
+				{},
+				{ T(1) / 5 },
+				{ T(3) / 40, T(9) / 40 },
+				{ T(44) / 45, T(-56) / 15, T(32) / 9 },
+				{ T(19372) / 6561, T(-25360) / 2187, T(64448) / 6561, T(-212) / 729 },
+				{ T(9017) / 3168, T(-355) / 33, T(46732) / 5247, T(49) / 176, T(-5103) / 18656 },
+				{ T(35) / 384, T(0), T(500) / 1113, T(125) / 192, T(-2187) / 6784, T(11) / 84 }
+			};
+
+			static constexpr T e[stages] = {
+				T(71) / 57600, T(0), T(-71) / 16695, T(71) / 1920, T(-17253) / 339200, T(22) / 525, T(-1) / 40
+			};
+
+			static constexpr T d[stages] = {
+				T(-12715105075.0L / 11282082432.0L),
+				T(0),
+				T(87487479700.0L / 32700410799.0L),
+				T(-10690763975.0L / 1880347072.0L),
+				T(701980252875.0L / 199316789632.0L),
+				T(-1453857185.0L / 822651844.0L),
+				T(69997945.0L / 29380423.0L)
+			};
+		};
+
+		template <std::floating_point T> void integrate_lanes(
+			const scenario<T>* const scenarios,
+			const std::size_t width,
+			const T t0,
+			const T* const times,
+			const std::size_t times_count,
+			T* const K,
+			T* const V,
+			integration_report* const reports,
+			const integration_options<T>& options
+		) noexcept {
+			using tableau = dormand_prince<T>;
+
+			T a1[lanes], b1[lanes], a2[lanes], b2[lanes];
+			T t[lanes], h[lanes], step[lanes], error[lanes];
+			T y[components][lanes], stage[components][lanes];
+			T k[stages][components][lanes];
+			std::size_t next[lanes], accepted[lanes], rejected[lanes];
+			bool active[lanes], success[lanes];
+
+			const auto t_end = times_count > 0 ? times[times_count - 1] : t0;
+			const auto rtol = options.relative_tolerance;
+			const auto atol = options.absolute_tolerance;
+
+			const auto rhs = [&](const T (&state)[components][lanes], T (&derivative)[components][lanes]) {
+				for (std::size_t l = 0; l < lanes; ++l) {
+					derivative[0][l] = state[0][l] * (b2[l] * state[1][l] - a2[l]);
+					derivative[1][l] = state[1][l] * (a1[l] - b1[l] * state[0][l]);
+				}
+			};
+
+			const auto emit = [&](const std::size_t l, const T K_value, const T V_value) {
+				K[l * times_count + next[l]] = K_value;
+				V[l * times_count + next[l]] = V_value;
+				++next[l];
+			};
+
+			// Padding lanes repeat the last scenario and are never written back
+			for (std::size_t l = 0; l < lanes; ++l) {
+				const auto& source = scenarios[std::min(l, width - 1)];
+
+				a1[l] = source.a1;
+				b1[l] = source.b1;
+				a2[l] = source.a2;
+				b2[l] = source.b2;
+				y[0][l] = source.K0;
+				y[1][l] = source.V0;
+				t[l] = t0;
+				next[l] = 0;
+				accepted[l] = 0;
+				rejected[l] = 0;
+				success[l] = true;
+				active[l] = l < width;
+
+				if (active[l])
+					while (next[l] < times_count && times[next[l]] <= t0)
+						emit(l, y[0][l], y[1][l]);
+
+				active[l] = active[l] && next[l] < times_count;
+			}
+
+			rhs(y, k[0]);
+
+			// Hairer's first guess: 1% of the ratio between the scaled state and derivative norms
+			for (std::size_t l = 0; l < lanes; ++l) {
+				T state_norm = 0;
+				T derivative_norm = 0;
+
+				for (std::size_t c = 0; c < components; ++c) {
+					const auto scale = atol + rtol * std::abs(y[c][l]);
+					state_norm += (y[c][l] / scale) * (y[c][l] / scale);
+					derivative_norm += (k[0][c][l] / scale) * (k[0][c][l] / scale);
+				}
+
+				h[l] = state_norm < T(1e-10) || derivative_norm < T(1e-10) ? T(1e-6) : T(0.01) * std::sqrt(state_norm / derivative_norm);
+				h[l] = std::min({ h[l], options.max_step, t_end - t0 });
+			}
+
+			while (std::any_of(active, active + lanes, [](const bool a) { return a; })) {
+
+				// Finished lanes step by 0, which leaves their state untouched
+				for (std::size_t l = 0; l < lanes; ++l)
+					step[l] = active[l] ? h[l] : T(0);
+
+				for (std::size_t i = 1; i < stages; ++i) {
+					for (std::size_t c = 0; c < components; ++c)
+						for (std::size_t l = 0; l < lanes; ++l) {
+							T acc = 0;
+
+							for (std::size_t j = 0; j < i; ++j)
+								acc += tableau::a[i][j] * k[j][c][l];
+
+							stage[c][l] = y[c][l] + step[l] * acc;
+						}
+
+					rhs(stage, k[i]);
+				}
+
+				for (std::size_t l = 0; l < lanes; ++l) {
+					T sum = 0;
+
+					for (std::size_t c = 0; c < components; ++c) {
+						T acc = 0;
+
+						for (std::size_t j = 0; j < stages; ++j)
+							acc += tableau::e[j] * k[j][c][l];
+
+						const auto scale = atol + rtol * std::max(std::abs(y[c][l]), std::abs(stage[c][l]));
+						const auto ratio = step[l] * acc / scale;
+						sum += ratio * ratio;
+					}
+
+					error[l] = std::sqrt(sum / components);
+				}
+
+				for (std::size_t l = 0; l < lanes; ++l) {
+					if (!active[l])
+						continue;
+
+					if (!std::isfinite(error[l]) || accepted[l] + rejected[l] >= options.max_steps) {
+						active[l] = false;
+						success[l] = false;
+						continue;
+					}
+
+					T factor;
+
+					if (error[l] <= 1) {
+						const auto last = h[l] >= t_end - t[l];
+						const auto t_new = last ? t_end : t[l] + h[l];
+
+						// Hairer's contd5 polynomial through every output time inside the step
+						while (next[l] < times_count && times[next[l]] <= t_new) {
+							const auto theta = (times[next[l]] - t[l]) / h[l];
+							const auto theta1 = 1 - theta;
+							T value[components];
+
+							for (std::size_t c = 0; c < components; ++c) {
+								const auto difference = stage[c][l] - y[c][l];
+								const auto slope = h[l] * k[0][c][l] - difference;
+								const auto curvature = difference - h[l] * k[6][c][l] - slope;
+								T correction = 0;
+
+								for (std::size_t j = 0; j < stages; ++j)
+									correction += tableau::d[j] * k[j][c][l];
+
+								value[c] = y[c][l] + theta * (difference + theta1 * (slope + theta * (curvature + theta1 * h[l] * correction)));
+							}
+
+							emit(l, value[0], value[1]);
+						}
+
+						for (std::size_t c = 0; c < components; ++c) {
+							y[c][l] = stage[c][l];
+							k[0][c][l] = k[6][c][l];
+						}
+
+						t[l] = t_new;
+						++accepted[l];
+
+						if (last || next[l] == times_count) {
+							active[l] = false;
+							continue;
+						}
+
+						factor = error[l] == 0 ? T(5) : std::min(T(5), std::max(T(0.2), T(0.9) * std::pow(error[l], T(-0.2))));
+					} else {
+						++rejected[l];
+						factor = std::max(T(0.2), T(0.9) * std::pow(error[l], T(-0.2)));
+					}
+
+					h[l] = std::min({ h[l] * factor, options.max_step, t_end - t[l] });
+
+					if (!(h[l] > std::abs(t[l]) * std::numeric_limits<T>::epsilon())) {
+						active[l] = false;
+						success[l] = false;
+					}
+				}
+			}
+
+			for (std::size_t l = 0; l < width; ++l) {
+				while (next[l] < times_count)
+					emit(l, std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::quiet_NaN());
+
+				if (reports != nullptr)
+					reports[l] = integration_report { accepted[l], rejected[l], success[l] };
+			}
+		}
+	}
+
+	// ########################## Batch evaluation ##########################
+
+	template <std::floating_point T> void evaluate(const model<T>& m, const T* const times, const std::size_t count, const trajectories<T>& out) noexcept {
+		const auto blocks = (count + block - 1) / block;
+
+		agla::par::thread_pool::instance().parallel_for(0, blocks, agla::par::thread_pool::grain_for(block * 32), [&](const std::size_t from, const std::size_t to) {
+			T sin[block];
+			T cos[block];
+
+			for (std::size_t b = from; b < to; ++b) {
+				const auto offset = b * block;
+				const auto size = std::min(block, count - offset);
+
+				// Same argument for both calls, which compilers fuse into a single sincos
+				for (std::size_t i = 0; i < size; ++i) {
+					const auto angle = m.omega * times[offset + i];
+					sin[i] = std::sin(angle);
+					cos[i] = std::cos(angle);
+				}
+
+				write_block(m, sin, cos, offset, size, out);
+			}
+		});
+	}
+
+	template <std::floating_point T> void evaluate_uniform(
+		const model<T>& m,
+		const T t0,
+		const T dt,
+		const std::size_t count,
+		const trajectories<T>& out
+	) noexcept {
+		const auto blocks = (count + block - 1) / block;
+		const auto step = m.omega * dt;
+
+		T table_sin[block];
+		T table_cos[block];
+
+		for (std::size_t j = 0; j < std::min(block, count); ++j) {
+			table_sin[j] = std::sin(static_cast<T>(j) * step);
+			table_cos[j] = std::cos(static_cast<T>(j) * step);
+		}
+
+		agla::par::thread_pool::instance().parallel_for(0, blocks, agla::par::thread_pool::grain_for(block * 8), [&](const std::size_t from, const std::size_t to) {
+			T sin[block];
+			T cos[block];
+
+			for (std::size_t b = from; b < to; ++b) {
+				const auto offset = b * block;
+				const auto size = std::min(block, count - offset);
+				const auto angle = m.omega * (t0 + static_cast<T>(offset) * dt);
+				const auto seed_sin = std::sin(angle);
+				const auto seed_cos = std::cos(angle);
+
+				for (std::size_t j = 0; j < size; ++j) {
+					sin[j] = seed_sin * table_cos[j] + seed_cos * table_sin[j];
+					cos[j] = seed_cos * table_cos[j] - seed_sin * table_sin[j];
+				}
+
+				write_block(m, sin, cos, offset, size, out);
+			}
+		});
+	}
+
+	// ########################## Nonlinear system ##########################
+
+	template <std::floating_point T> void integrate(
+		const scenario<T>* const scenarios,
+		const std::size_t count,
+		const T t0,
+		const T* const times,
+		const std::size_t times_count,
+		T* const K,
+		T* const V,
+		integration_report* const reports,
+		const integration_options<T>& options
+	) noexcept {
+		const auto batches = (count + lanes - 1) / lanes;
+
+		agla::par::thread_pool::instance().parallel_for(0, batches, 1, [&](const std::size_t from, const std::size_t to) {
+			for (std::size_t b = from; b < to; ++b) {
+				const auto first = b * lanes;
+
+				integrate_lanes(
+					scenarios + first,
+					std::min(lanes, count - first),
+					t0,
+					times,
+					times_count,
+					K + first * times_count,
+					V + first * times_count,
+					reports != nullptr ? reports + first : nullptr,
+					options
+				);
+			}
+		});
+	}
+
+	template void evaluate(const model<float>& m, const float* times, std::size_t count, const trajectories<float>& out) noexcept;
+	template void evaluate(const model<double>& m, const double* times, std::size_t count, const trajectories<double>& out) noexcept;
+	template void evaluate(const model<long double>& m, const long double* times, std::size_t count, const trajectories<long double>& out) noexcept;
+
+	template void evaluate_uniform(const model<float>& m, float t0, float dt, std::size_t count, const trajectories<float>& out) noexcept;
+	template void evaluate_uniform(const model<double>& m, double t0, double dt, std::size_t count, const trajectories<double>& out) noexcept;
+	template void evaluate_uniform(const model<long double>& m, long double t0, long double dt, std::size_t count, const trajectories<long double>& out) noexcept;
+
+	template void integrate(
+		const scenario<float>* scenarios,
+		std::size_t count,
+		float t0,
+		const float* times,
+		std::size_t times_count,
+		float* K,
+		float* V,
+		integration_report* reports,
+		const integration_options<float>& options
+	) noexcept;
+
+	template void integrate(
+		const scenario<double>* scenarios,
+		std::size_t count,
+		double t0,
+		const double* times,
+		std::size_t times_count,
+		double* K,
+		double* V,
+		integration_report* reports,
+		const integration_options<double>& options
+	) noexcept;
+
+	template void integrate(
+		const scenario<long double>* scenarios,
+		std::size_t count,
+		long double t0,
+		const long double* times,
+		std::size_t times_count,
+		long double* K,
+		long double* V,
+		integration_report* reports,
+		const integration_options<long double>& options
+	) noexcept;
+}
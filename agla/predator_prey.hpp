@@ -2,8 +2,116 @@
 #define PREDATOR_PREY_HPP
 
 #include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
 
 namespace predator_prey {
+
+	// ########################## Model ##########################
+
+	// Parameter-dependent constants of the linearized solution, computed once per parameter set:
+	// k(t) = k_sin * sin(omega * t) + k_cos * cos(omega * t), v(t) = v_sin * sin(omega * t) + v_cos * cos(omega * t)
+	template <std::floating_point T> struct model {
+		T omega;
+		T k_sin;
+		T k_cos;
+		T v_sin;
+		T v_cos;
+		T k_offset;
+		T v_offset;
+
+		[[nodiscard]] static constexpr model from_parameters(
+			const T a1,
+			const T b1,
+			const T a2,
+			const T b2,
+			const T v0,
+			const T k0
+		) noexcept {
+			const auto sqrt_a1 = std::sqrt(a1);
+			const auto sqrt_a2 = std::sqrt(a2);
+
+			return model {
+				sqrt_a1 * sqrt_a2,
+				v0 * (sqrt_a1 * b2 / (b1 * sqrt_a2)),
+				k0,
+				-k0 * (sqrt_a2 * b1 / (b2 * sqrt_a1)),
+				v0,
+				a1 / b1,
+				a2 / b2
+			};
+		}
+
+		[[nodiscard]] constexpr T k(const T time) const noexcept { return k_sin * std::sin(omega * time) + k_cos * std::cos(omega * time); }
+		[[nodiscard]] constexpr T K(const T time) const noexcept { return k(time) + k_offset; }
+		[[nodiscard]] constexpr T v(const T time) const noexcept { return v_sin * std::sin(omega * time) + v_cos * std::cos(omega * time); }
+		[[nodiscard]] constexpr T V(const T time) const noexcept { return v(time) + v_offset; }
+	};
+
+	// Caller-owned output arrays of at least count elements; null ones are skipped
+	template <std::floating_point T> struct trajectories {
+		T* k = nullptr;
+		T* K = nullptr;
+		T* v = nullptr;
+		T* V = nullptr;
+	};
+
+	// ########################## Batch evaluation ##########################
+
+	// One sin/cos pair per sample, shared by all four trajectories
+	template <std::floating_point T> void evaluate(const model<T>& m, const T* times, std::size_t count, const trajectories<T>& out) noexcept;
+
+	// Samples t0 + i * dt. Each block of the grid takes one exact sin/cos and expands it by angle
+	// addition against a per-call table of sin(j * omega * dt), so rounding does not accumulate
+	// along the grid and the inner loop is plain multiply-adds
+	template <std::floating_point T> void evaluate_uniform(const model<T>& m, T t0, T dt, std::size_t count, const trajectories<T>& out) noexcept;
+
+	// ########################## Nonlinear system ##########################
+
+	// K' = K * (b2 * V - a2), V' = V * (a1 - b1 * K); its linearization around (a1 / b1, a2 / b2)
+	// is the closed form above, with K0 and V0 the absolute initial populations
+	template <std::floating_point T> struct scenario {
+		T a1;
+		T b1;
+		T a2;
+		T b2;
+		T K0;
+		T V0;
+	};
+
+	template <std::floating_point T> struct integration_options {
+		T relative_tolerance = T(1e-8);
+		T absolute_tolerance = T(1e-10);
+		T max_step = std::numeric_limits<T>::infinity();
+		std::size_t max_steps = 1'000'000;
+	};
+
+	struct integration_report {
+		std::size_t accepted;
+		std::size_t rejected;
+		bool success;
+	};
+
+	// Adaptive Dormand-Prince 5(4) with Hairer's dense output, so output times never shorten a step.
+	// Scenarios are integrated in lanes that share every arithmetic loop but keep their own time and
+	// step size; batches of lanes run on the shared pool. times must be ascending and not before t0.
+	// K and V receive count * times_count values, scenario-major, NaN past a failed integration;
+	// reports may be null
+	template <std::floating_point T> void integrate(
+		const scenario<T>* scenarios,
+		std::size_t count,
+		T t0,
+		const T* times,
+		std::size_t times_count,
+		T* K,
+		T* V,
+		integration_report* reports,
+		const integration_options<T>& options = {}
+	) noexcept;
+
+	// ########################## Scalar evaluation ##########################
+
 	constexpr inline long double k(
 		const long double time,
 		const long double a1,
@@ -12,10 +120,7 @@ namespace predator_prey {
 		const long double b2,
 		const long double v0,
 		const long double k0
-	) noexcept {
-		return v0 * (std::sqrt(a1) * b2 / (b1 * std::sqrt(a2))) * std::sin(std::sqrt(a1 * a2) * time)
-			   + k0 * std::cos(std::sqrt(a1 * a2) * time);
-	}
+	) noexcept { return model<long double>::from_parameters(a1, b1, a2, b2, v0, k0).k(time); }
 
 	constexpr inline long double K(
 		const long double time,
@@ -25,7 +130,7 @@ namespace predator_prey {
 		const long double b2,
 		const long double v0,
 		const long double k0
-	) noexcept { return k(time, a1, b1, a2, b2, v0, k0) + a1 / b1; }
+	) noexcept { return model<long double>::from_parameters(a1, b1, a2, b2, v0, k0).K(time); }
 
 	constexpr inline long double v(
 		const long double time,
@@ -35,10 +140,7 @@ namespace predator_prey {
 		const long double b2,
 		const long double v0,
 		const long double k0
-	) noexcept {
-		return v0 * std::cos(std::sqrt(a1 * a2) * time) -
-			   k0 * (std::sqrt(a2) * b1 / (b2 * std::sqrt(a1))) * std::sin(std::sqrt(a1 * a2) * time);
-	}
+	) noexcept { return model<long double>::from_parameters(a1, b1, a2, b2, v0, k0).v(time); }
 
 	constexpr inline long double V(
 		const long double time,
@@ -48,7 +150,7 @@ namespace predator_prey {
 		const long double b2,
 		const long double v0,
 		const long double k0
-	) noexcept { return v(time, a1, b1, a2, b2, v0, k0) + a2 / b2; }
+	) noexcept { return model<long double>::from_parameters(a1, b1, a2, b2, v0, k0).V(time); }
 }
 
 #endif //PREDATOR_PREY_HPP
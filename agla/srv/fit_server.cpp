@@ -0,0 +1,365 @@
+#include <cerrno>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "fit_server.hpp"
+#include "io.hpp"
+#include "../par/thread_pool.hpp"
+
+namespace agla::srv {
+	namespace {
+		// ########################## Connection ##########################
+
+		// Responses go through a per-connection outbox drained by its own writer, so a peer that
+		// stops reading stalls only itself and never the dispatcher
+		struct connection {
+			struct outgoing {
+				fit_response response;
+
+				// Of the request it answers, released once written
+				std::size_t bytes;
+			};
+
+			int in_fd;
+			int out_fd;
+			bool owned;
+
+			std::mutex mutex;
+			std::condition_variable changed;
+			std::deque<outgoing> outbox;
+
+			// Requests queued or being solved, and the bytes of those plus the unwritten answers
+			std::size_t outstanding = 0;
+			std::size_t queued_bytes = 0;
+			bool reading = true;
+
+			connection(const int in_fd, const int out_fd, const bool owned) noexcept : in_fd(in_fd), out_fd(out_fd), owned(owned) {}
+
+			~connection() noexcept {
+				if (!owned)
+					return;
+
+				::close(in_fd);
+
+				if (out_fd != in_fd)
+					::close(out_fd);
+			}
+
+			void wait_below(const std::size_t limit) noexcept {
+				std::unique_lock lock(mutex);
+				changed.wait(lock, [this, limit] { return queued_bytes < limit; });
+			}
+
+			void admit(const std::size_t bytes) noexcept {
+				std::lock_guard lock(mutex);
+				++outstanding;
+				queued_bytes += bytes;
+			}
+
+			// bytes is 0 for responses the reader sends without admitting a request
+			void respond(fit_response&& response, const std::size_t bytes) noexcept {
+				std::lock_guard lock(mutex);
+				outbox.push_back(outgoing { std::move(response), bytes });
+				outstanding -= bytes > 0 ? 1 : 0;
+				changed.notify_all();
+			}
+
+			void stop_reading() noexcept {
+				std::lock_guard lock(mutex);
+				reading = false;
+				changed.notify_all();
+			}
+
+			// Returns once the reader has stopped and every admitted request is written out.
+			// After a failed write the remaining responses are dropped
+			void write_loop() noexcept {
+				bool broken = false;
+
+				for (;;) {
+					outgoing next;
+
+					{
+						std::unique_lock lock(mutex);
+						changed.wait(lock, [this] { return !outbox.empty() || (!reading && outstanding == 0); });
+
+						if (outbox.empty())
+							return;
+
+						next = std::move(outbox.front());
+						outbox.pop_front();
+					}
+
+					broken = broken || !write_response(out_fd, next.response);
+
+					std::lock_guard lock(mutex);
+					queued_bytes -= next.bytes;
+					changed.notify_all();
+				}
+			}
+		};
+
+		// ########################## Dispatcher ##########################
+
+		// Readers block on their own connection and queue whole requests; the dispatcher drains
+		// whatever has arrived since the last batch, so batches grow with load and an idle server
+		// answers a lone request immediately
+		class dispatcher {
+			struct pending {
+				std::shared_ptr<connection> origin;
+				fit_request request;
+				std::size_t bytes;
+			};
+
+			std::mutex mutex;
+			std::condition_variable ready;
+			std::deque<pending> queue;
+			std::size_t readers = 0;
+			bool accepting = false;
+
+			lsq::factorization_cache<double> cache;
+			const bool caching;
+			const std::size_t connection_queue_bytes;
+
+		 public:
+			explicit dispatcher(const server_options& options) noexcept
+				: cache(options.cache_capacity, options.cache_bytes), caching(options.cache_capacity > 0), connection_queue_bytes(options.connection_queue_bytes) {}
+
+			void set_accepting(const bool value) noexcept {
+				std::lock_guard lock(mutex);
+				accepting = value;
+				ready.notify_all();
+			}
+
+			void add_reader() noexcept {
+				std::lock_guard lock(mutex);
+				++readers;
+			}
+
+			void read_loop(const std::shared_ptr<connection>& origin) noexcept {
+				std::thread writer([origin] { origin->write_loop(); });
+
+				for (;;) {
+					origin->wait_below(connection_queue_bytes);
+
+					fit_request request {};
+					const auto result = read_request(origin->in_fd, request);
+
+					if (result != read_status::ok) {
+						if (result == read_status::rejected)
+							origin->respond(fit_response { { response_magic, request.header.id, status::bad_request, 0, 0, 0, 0, 0 }, {} }, 0);
+
+						break;
+					}
+
+					const auto bytes = sizeof(request_header) + 2 * request.x.size() * sizeof(double);
+					origin->admit(bytes);
+
+					std::lock_guard lock(mutex);
+					queue.push_back(pending { origin, std::move(request), bytes });
+					ready.notify_one();
+				}
+
+				origin->stop_reading();
+				writer.join();
+
+				std::lock_guard lock(mutex);
+				--readers;
+				ready.notify_all();
+			}
+
+			void run(const server_options& options) noexcept {
+				std::vector<pending> batch;
+				std::vector<fit_response> responses;
+
+				for (;;) {
+					{
+						std::unique_lock lock(mutex);
+						ready.wait(lock, [this] { return !queue.empty() || (readers == 0 && !accepting); });
+
+						if (queue.empty())
+							return;
+
+						batch.clear();
+
+						while (!queue.empty() && batch.size() < std::max<std::size_t>(options.max_batch, 1)) {
+							batch.push_back(std::move(queue.front()));
+							queue.pop_front();
+						}
+					}
+
+					responses.resize(batch.size());
+
+					par::thread_pool::instance().parallel_for(0, batch.size(), 1, [&](const std::size_t from, const std::size_t to) {
+						for (std::size_t i = from; i < to; ++i)
+							responses[i] = solve(batch[i].request, caching ? &cache : nullptr);
+					});
+
+					for (std::size_t i = 0; i < batch.size(); ++i)
+						batch[i].origin->respond(std::move(responses[i]), batch[i].bytes);
+				}
+			}
+		};
+	}
+
+	// ########################## Protocol ##########################
+
+	[[nodiscard]] read_status read_request(const int fd, fit_request& request) noexcept {
+		if (!read_exact(fd, &request.header, sizeof(request_header)) || request.header.magic != request_magic)
+			return read_status::closed;
+
+		const auto points = static_cast<std::size_t>(request.header.points);
+
+		if (points > max_points || points * (static_cast<std::size_t>(request.header.degree) + 1) > max_design_elements)
+			return read_status::rejected;
+
+		request.x.resize(points);
+		request.y.resize(points);
+
+		if (!read_exact(fd, request.x.data(), points * sizeof(double)) || !read_exact(fd, request.y.data(), points * sizeof(double)))
+			return read_status::closed;
+
+		return read_status::ok;
+	}
+
+	[[nodiscard]] bool write_response(const int fd, const fit_response& response) noexcept {
+		return write_exact(fd, &response.header, sizeof(response_header))
+			   && write_exact(fd, response.coefficients.data(), response.coefficients.size() * sizeof(double));
+	}
+
+	[[nodiscard]] fit_response solve(const fit_request& request, lsq::factorization_cache<double>* const cache) noexcept {
+		const auto& header = request.header;
+		const auto columns = static_cast<std::size_t>(header.degree) + 1;
+		const auto points = request.x.size();
+
+		fit_response response { { response_magic, header.id, status::ok, 0, 0, 0, 0, 0 }, {} };
+
+		const auto well_formed = header.points == points && request.y.size() == points && header.degree <= max_degree
+								 && points >= columns && points * columns <= max_design_elements;
+
+		if (!well_formed || header.solver > solver_choice::svd || !(header.rank_tolerance >= 0)) {
+			response.header.result = status::bad_request;
+			return response;
+		}
+
+		std::shared_ptr<const lsq::least_squares_factorization<double>> factorization;
+
+		if (cache != nullptr && header.solver == solver_choice::automatic && header.rank_tolerance == 0) {
+			factorization = cache->get(request.x, header.degree);
+		} else {
+			lsq::least_squares_options<double> options;
+			options.rank_tolerance = header.rank_tolerance;
+
+			if (header.solver != solver_choice::automatic)
+				options.force = static_cast<lsq::solver>(static_cast<std::uint8_t>(header.solver) - 1);
+
+			auto built = lsq::least_squares_factorization<double>::from_matrix(lsq::vandermonde(request.x, header.degree), options);
+
+			if (built.has_value())
+				factorization = std::make_shared<const lsq::least_squares_factorization<double>>(std::move(*built));
+		}
+
+		if (factorization == nullptr) {
+			response.header.result = status::failed;
+			return response;
+		}
+
+		response.coefficients.resize(columns);
+		factorization->solve_unchecked(request.y.data(), response.coefficients.data());
+
+		// Horner, so the residual needs no design matrix
+		double residual = 0;
+
+		for (std::size_t i = 0; i < request.y.size(); ++i) {
+			double p = response.coefficients[columns - 1];
+
+			for (std::size_t k = columns - 1; k-- > 0;)
+				p = p * request.x[i] + response.coefficients[k];
+
+			residual += (p - request.y[i]) * (p - request.y[i]);
+		}
+
+		response.header.solver = static_cast<std::uint8_t>(factorization->method());
+		response.header.coefficients = static_cast<std::uint16_t>(columns);
+		response.header.rank = static_cast<std::uint32_t>(factorization->rank());
+		response.header.condition_estimate = factorization->condition_estimate();
+		response.header.residual_norm = std::sqrt(residual);
+
+		if (!std::isfinite(response.header.residual_norm))
+			response.header.result = status::failed;
+
+		return response;
+	}
+
+	// ########################## Server ##########################
+
+	int serve_stream(const int in_fd, const int out_fd, const server_options& options) noexcept {
+		const auto shared = std::make_shared<dispatcher>(options);
+		const auto origin = std::make_shared<connection>(in_fd, out_fd, false);
+
+		shared->add_reader();
+		std::thread reader([shared, origin] { shared->read_loop(origin); });
+
+		shared->run(options);
+		reader.join();
+		return 0;
+	}
+
+	int serve_socket(const char* const path, const server_options& options) noexcept {
+		sockaddr_un address {};
+
+		if (std::strlen(path) >= sizeof(address.sun_path))
+			return 1;
+
+		address.sun_family = AF_UNIX;
+		std::strcpy(address.sun_path, path);
+
+		const auto listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+		if (listener < 0)
+			return 1;
+
+		::unlink(path);
+
+		if (::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, SOMAXCONN) != 0) {
+			::close(listener);
+			return 1;
+		}
+
+		// Readers and the acceptor share ownership, so none of them outlives the dispatcher
+		const auto shared = std::make_shared<dispatcher>(options);
+		shared->set_accepting(true);
+
+		std::thread acceptor([shared, listener] {
+			for (;;) {
+				const auto fd = ::accept(listener, nullptr, nullptr);
+
+				if (fd < 0) {
+					if (errno == EINTR || errno == ECONNABORTED)
+						continue;
+
+					break;
+				}
+
+				const auto origin = std::make_shared<connection>(fd, fd, true);
+				shared->add_reader();
+				std::thread([shared, origin] { shared->read_loop(origin); }).detach();
+			}
+
+			::close(listener);
+			shared->set_accepting(false);
+		});
+
+		shared->run(options);
+		acceptor.join();
+		return 0;
+	}
+} // agla::srv
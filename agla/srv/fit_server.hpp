@@ -0,0 +1,130 @@
+#ifndef FIT_SERVER_HPP
+#define FIT_SERVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../lsq/factorization_cache.hpp"
+
+namespace agla::srv {
+
+	// ########################## Protocol ##########################
+
+	// Frames are packed little structs in host byte order, meant for local sockets and pipes only.
+	// A request header is followed by points x values and points y values, a response header by
+	// coefficients values, all doubles. Responses carry the request id and may arrive out of order
+
+	constexpr std::uint32_t request_magic = 0x464C4741;  // "AGLF"
+	constexpr std::uint32_t response_magic = 0x524C4741; // "AGLR"
+
+	// Requests above this are answered with bad_request and the connection is closed
+	constexpr std::uint32_t max_points = 1 << 20;
+
+	// Requests above this are answered with bad_request
+	constexpr std::uint16_t max_degree = 255;
+
+	// Requests whose design matrix, points * (degree + 1) values, would exceed this are answered
+	// with bad_request and the connection is closed before their payload is allocated
+	constexpr std::size_t max_design_elements = 1 << 24;
+
+	enum class solver_choice : std::uint8_t {
+		automatic,
+		normal_equations,
+		qr,
+		svd
+	};
+
+	enum class status : std::uint8_t {
+		ok,
+		bad_request,
+		failed
+	};
+
+#pragma pack(push, 1)
+	struct request_header {
+		std::uint32_t magic;
+		std::uint32_t id;
+		std::uint32_t points;
+		std::uint16_t degree;
+		solver_choice solver;
+		std::uint8_t reserved;
+
+		// Relative singular value cutoff for the SVD path, 0 for the default
+		double rank_tolerance;
+	};
+
+	struct response_header {
+		std::uint32_t magic;
+		std::uint32_t id;
+		status result;
+
+		// lsq::solver that produced the coefficients
+		std::uint8_t solver;
+		std::uint16_t coefficients;
+		std::uint32_t rank;
+		double condition_estimate;
+		double residual_norm;
+	};
+#pragma pack(pop)
+
+	struct fit_request {
+		request_header header;
+		std::vector<double> x;
+		std::vector<double> y;
+	};
+
+	struct fit_response {
+		response_header header;
+		std::vector<double> coefficients;
+	};
+
+	enum class read_status : std::uint8_t {
+		ok,
+
+		// End of stream, an error or a bad magic; the header may not have been read
+		closed,
+
+		// A well-formed header whose payload is over the limits; only the header was read
+		rejected
+	};
+
+	// Blocking full-frame I/O
+	[[nodiscard]] read_status read_request(int fd, fit_request& request) noexcept;
+
+	// False on errors
+	[[nodiscard]] bool write_response(int fd, const fit_response& response) noexcept;
+
+	// Polynomial least-squares fit through lsq::least_squares_factorization. Requests with the
+	// automatic solver and default tolerance take their factorization from the cache, if given.
+	// Requests over the limits above or whose x and y do not hold points values get bad_request
+	[[nodiscard]] fit_response solve(const fit_request& request, lsq::factorization_cache<double>* cache = nullptr) noexcept;
+
+	// ########################## Server ##########################
+
+	struct server_options {
+
+		// Requests taken from the queue at once and solved together on the shared pool
+		std::size_t max_batch = 256;
+
+		// Distinct abscissa grids whose factorizations are kept; 0 disables the cache
+		std::size_t cache_capacity = 64;
+
+		// Bound on the bytes held by the cached factorizations
+		std::size_t cache_bytes = std::size_t(256) << 20;
+
+		// Request bytes one connection may have queued or awaiting their response before its
+		// reader stops reading; a frame is admitted whenever the connection is below the bound
+		std::size_t connection_queue_bytes = std::size_t(64) << 20;
+	};
+
+	// Answers requests from in_fd on out_fd until in_fd reaches end of stream
+	int serve_stream(int in_fd, int out_fd, const server_options& options = {}) noexcept;
+
+	// Listens on a Unix domain socket, replacing a stale socket file. Requests from all
+	// connections share one queue, so concurrent clients are batched together. Runs until
+	// accept fails; returns non-zero if the socket cannot be set up
+	int serve_socket(const char* path, const server_options& options = {}) noexcept;
+} // agla::srv
+
+#endif // FIT_SERVER_HPP
@@ -0,0 +1,45 @@
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "io.hpp"
+
+namespace agla::srv {
+	[[nodiscard]] bool read_exact(const int fd, void* const buf, const std::size_t size) noexcept {
+		auto* const bytes = static_cast<char*>(buf);
+		std::size_t done = 0;
+
+		while (done < size) {
+			const auto got = ::read(fd, bytes + done, size - done);
+
+			if (got > 0)
+				done += static_cast<std::size_t>(got);
+			else if (got == 0 || errno != EINTR)
+				return false;
+		}
+
+		return true;
+	}
+
+	[[nodiscard]] bool write_exact(const int fd, const void* const buf, const std::size_t size) noexcept {
+		const auto* const bytes = static_cast<const char*>(buf);
+		std::size_t done = 0;
+
+		while (done < size) {
+
+			// send() keeps a vanished client from raising SIGPIPE; pipes and files fall back to write()
+			auto put = ::send(fd, bytes + done, size - done, MSG_NOSIGNAL);
+
+			if (put < 0 && errno == ENOTSOCK)
+				put = ::write(fd, bytes + done, size - done);
+
+			if (put > 0)
+				done += static_cast<std::size_t>(put);
+			else if (put == 0 || errno != EINTR)
+				return false;
+		}
+
+		return true;
+	}
+} // agla::srv
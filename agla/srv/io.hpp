@@ -0,0 +1,14 @@
+#ifndef IO_HPP
+#define IO_HPP
+
+#include <cstddef>
+
+namespace agla::srv {
+
+	// Whole-buffer blocking I/O that retries on EINTR and partial transfers. False on end of
+	// stream or errors; writes to sockets never raise SIGPIPE
+	[[nodiscard]] bool read_exact(int fd, void* buf, std::size_t size) noexcept;
+	[[nodiscard]] bool write_exact(int fd, const void* buf, std::size_t size) noexcept;
+} // agla::srv
+
+#endif // IO_HPP
@@ -0,0 +1,221 @@
+#include <charconv>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "shard.hpp"
+#include "io.hpp"
+
+extern char** environ;
+
+namespace agla::srv {
+	namespace {
+		struct worker {
+			pid_t pid;
+			int fd;
+		};
+
+		// Stdout of the child goes to the returned pipe
+		[[nodiscard]] std::optional<worker> spawn(const char* const executable, const std::vector<std::string>& arguments, const std::vector<std::string>& environment) noexcept {
+			int fds[2];
+
+			// Close-on-exec, so later workers do not inherit earlier pipes; dup2 clears it for stdout
+			if (::pipe2(fds, O_CLOEXEC) != 0)
+				return std::nullopt;
+
+			std::vector<char*> argv { const_cast<char*>(executable) };
+			std::vector<char*> envp;
+
+			for (const auto& argument : arguments)
+				argv.push_back(const_cast<char*>(argument.c_str()));
+
+			for (const auto& variable : environment)
+				envp.push_back(const_cast<char*>(variable.c_str()));
+
+			argv.push_back(nullptr);
+			envp.push_back(nullptr);
+
+			posix_spawn_file_actions_t actions;
+			posix_spawn_file_actions_init(&actions);
+			posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+
+			pid_t pid;
+			const auto result = posix_spawn(&pid, executable, &actions, nullptr, argv.data(), envp.data());
+
+			posix_spawn_file_actions_destroy(&actions);
+			::close(fds[1]);
+
+			if (result != 0) {
+				::close(fds[0]);
+				return std::nullopt;
+			}
+
+			return std::make_optional(worker { pid, fds[0] });
+		}
+	}
+
+	// ########################## Summary ##########################
+
+	[[nodiscard]] bool write_factor(const int fd, const lsq::tsqr_factor<double>& factor) noexcept {
+		const auto width = factor.r.rows_number();
+		const factor_header header { factor_magic, static_cast<std::uint32_t>(width), factor.rows };
+
+		if (!write_exact(fd, &header, sizeof(header)))
+			return false;
+
+		for (std::size_t i = 0; i < width; ++i)
+			if (!write_exact(fd, factor.r.get_unchecked(i).data(), width * sizeof(double)))
+				return false;
+
+		return true;
+	}
+
+	[[nodiscard]] std::optional<lsq::tsqr_factor<double>> read_factor(const int fd) noexcept {
+		factor_header header;
+
+		if (!read_exact(fd, &header, sizeof(header)) || header.magic != factor_magic || header.width < 2 || header.width > 1 << 12)
+			return std::nullopt;
+
+		mtx::square_matrix<double> r(header.width);
+
+		for (std::size_t i = 0; i < header.width; ++i)
+			if (!read_exact(fd, r.get_unchecked(i).data(), header.width * sizeof(double)))
+				return std::nullopt;
+
+		return std::make_optional(lsq::tsqr_factor<double> { std::move(r), static_cast<std::size_t>(header.rows) });
+	}
+
+	// ########################## Worker ##########################
+
+	[[nodiscard]] std::optional<std::size_t> parse_size(const char* const text) noexcept {
+		std::size_t value = 0;
+		const auto end = text + std::strlen(text);
+		const auto [next, error] = std::from_chars(text, end, value);
+
+		if (error != std::errc() || next != end)
+			return std::nullopt;
+
+		return std::make_optional(value);
+	}
+
+	[[nodiscard]] std::vector<std::string> shard_arguments(const shard_spec& spec) noexcept {
+		return {
+			spec.path,
+			std::to_string(spec.width),
+			std::to_string(spec.first_row),
+			std::to_string(spec.rows),
+			spec.degree.has_value() ? std::to_string(*spec.degree) : "-",
+			spec.kind == lsq::basis::chebyshev ? "c" : "m"
+		};
+	}
+
+	[[nodiscard]] std::optional<shard_spec> parse_shard_arguments(const int argc, const char* const* const argv) noexcept {
+		if (argc != 6)
+			return std::nullopt;
+
+		const auto width = parse_size(argv[1]);
+		const auto first_row = parse_size(argv[2]);
+		const auto rows = parse_size(argv[3]);
+		const auto degree = std::strcmp(argv[4], "-") == 0 ? std::nullopt : parse_size(argv[4]);
+		const auto chebyshev = std::strcmp(argv[5], "c") == 0;
+
+		if (!width || !first_row || !rows || (!degree && std::strcmp(argv[4], "-") != 0) || (!chebyshev && std::strcmp(argv[5], "m") != 0))
+			return std::nullopt;
+
+		return std::make_optional(shard_spec { argv[0], *width, *first_row, *rows, degree, chebyshev ? lsq::basis::chebyshev : lsq::basis::monomial });
+	}
+
+	int run_shard_worker(const shard_spec& spec, const int out_fd, const lsq::tsqr_options<double>& options) noexcept {
+		auto rows = lsq::row_source<double>::binary_file(spec.path.c_str(), spec.width, spec.first_row, spec.rows);
+
+		if (!rows.has_value() || (spec.degree.has_value() && spec.width != 2))
+			return 1;
+
+		auto source = spec.degree.has_value() ? lsq::row_source<double>::polynomial(std::move(*rows), *spec.degree, spec.kind) : std::move(*rows);
+		const auto factor = lsq::tsqr_factor<double>::from_source(source, options);
+
+		// An empty slice still reports a zero factor, so the coordinator sees every shard
+		const auto width = source.width;
+		const auto summary = factor.has_value() ? *factor : lsq::tsqr_factor<double> { mtx::square_matrix<double>(width), 0 };
+
+		return write_factor(out_fd, summary) ? 0 : 1;
+	}
+
+	// ########################## Coordinator ##########################
+
+	[[nodiscard]] std::optional<lsq::tsqr_solution<double>> sharded_fit(
+		const char* const executable,
+		const shard_spec& job,
+		const sharded_fit_options& options
+	) noexcept {
+		struct stat info;
+
+		if (::stat(job.path.c_str(), &info) != 0 || job.width == 0)
+			return std::nullopt;
+
+		const auto file_rows = static_cast<std::size_t>(info.st_size) / (job.width * sizeof(double));
+		const auto first = std::min(job.first_row, file_rows);
+		const auto total = std::min(job.rows, file_rows - first);
+		const auto workers = std::max<std::size_t>(options.workers, 1);
+
+		// Workers split the cores instead of each sizing its pool by the whole machine
+		std::vector<std::string> environment;
+		const auto threads = std::max<std::size_t>(std::thread::hardware_concurrency() / workers, 1);
+
+		for (auto** it = environ; *it != nullptr; ++it)
+			if (std::strncmp(*it, "AGLA_NUM_THREADS=", 17) != 0)
+				environment.emplace_back(*it);
+
+		environment.push_back("AGLA_NUM_THREADS=" + std::to_string(threads));
+
+		std::vector<worker> running;
+		bool failed = false;
+
+		for (std::size_t k = 0; k < workers && !failed; ++k) {
+			auto slice = job;
+			slice.first_row = first + k * total / workers;
+			slice.rows = (k + 1) * total / workers - k * total / workers;
+
+			auto arguments = shard_arguments(slice);
+			arguments.insert(arguments.begin(), "--shard-worker");
+
+			const auto spawned = spawn(executable, arguments, environment);
+
+			if (spawned.has_value())
+				running.push_back(*spawned);
+			else
+				failed = true;
+		}
+
+		// Slice order keeps the merged factor independent of which worker finishes first
+		std::optional<lsq::tsqr_factor<double>> merged;
+
+		for (const auto& w : running) {
+			auto factor = failed ? std::nullopt : read_factor(w.fd);
+			::close(w.fd);
+
+			int status = 0;
+			::waitpid(w.pid, &status, 0);
+
+			if (!factor.has_value() || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || (merged.has_value() && merged->r.rows_number() != factor->r.rows_number())) {
+				failed = true;
+				continue;
+			}
+
+			if (merged.has_value())
+				merged = merged->merged_unchecked(*factor);
+			else
+				merged = std::move(factor);
+		}
+
+		if (failed || !merged.has_value())
+			return std::nullopt;
+
+		return merged->solve(options.rank_tolerance);
+	}
+} // agla::srv
@@ -0,0 +1,74 @@
+#ifndef SHARD_HPP
+#define SHARD_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../lsq/tsqr.hpp"
+
+namespace agla::srv {
+
+	// ########################## Summary ##########################
+
+	// A shard's whole contribution is its TSQR factor: a header followed by width * width doubles
+	// of R, row-major, in host byte order. Works over pipes and sockets alike
+	constexpr std::uint32_t factor_magic = 0x53474C41; // "ALGS"
+
+#pragma pack(push, 1)
+	struct factor_header {
+		std::uint32_t magic;
+		std::uint32_t width;
+		std::uint64_t rows;
+	};
+#pragma pack(pop)
+
+	[[nodiscard]] bool write_factor(int fd, const lsq::tsqr_factor<double>& factor) noexcept;
+
+	// Nullopt on end of stream, errors or a bad header
+	[[nodiscard]] std::optional<lsq::tsqr_factor<double>> read_factor(int fd) noexcept;
+
+	// ########################## Worker ##########################
+
+	// Rows [first_row, first_row + rows) of a binary file of doubles, width per row. With a
+	// degree, rows are points (x, y) expanded into polynomial design rows
+	struct shard_spec {
+		std::string path;
+		std::size_t width;
+		std::size_t first_row = 0;
+		std::size_t rows = std::numeric_limits<std::size_t>::max();
+		std::optional<std::size_t> degree = std::nullopt;
+		lsq::basis kind = lsq::basis::monomial;
+	};
+
+	// Whole-string unsigned decimal, as the command-line forms use; nullopt on anything else
+	[[nodiscard]] std::optional<std::size_t> parse_size(const char* text) noexcept;
+
+	// Command-line form of a spec: path width first_row rows degree|- m|c
+	[[nodiscard]] std::vector<std::string> shard_arguments(const shard_spec& spec) noexcept;
+	[[nodiscard]] std::optional<shard_spec> parse_shard_arguments(int argc, const char* const* argv) noexcept;
+
+	// Factorizes the slice and writes its summary to out_fd; the body of a worker process.
+	// Returns the process exit code
+	int run_shard_worker(const shard_spec& spec, int out_fd, const lsq::tsqr_options<double>& options = {}) noexcept;
+
+	// ########################## Coordinator ##########################
+
+	struct sharded_fit_options {
+		std::size_t workers = 4;
+
+		// As in lsq::tsqr_options
+		double rank_tolerance = 0;
+	};
+
+	// Splits the rows of job into contiguous slices and runs `executable --shard-worker <slice>`
+	// for each, stdout on a pipe and AGLA_NUM_THREADS set so the workers share the cores. The
+	// summaries are merged in slice order and solved here. Nullopt when a worker fails
+	[[nodiscard]] std::optional<lsq::tsqr_solution<double>> sharded_fit(
+		const char* executable,
+		const shard_spec& job,
+		const sharded_fit_options& options = {}
+	) noexcept;
+} // agla::srv
+
+#endif // SHARD_HPP
@@ -1,10 +1,50 @@
 #include <random>
 #include <sstream>
+#include <string_view>
 
 #include "gnuplot-cpp/gnuplot_i.hpp"
-#include "agla/mtx/column_vector.hpp"
+#include "agla/lsq/least_squares.hpp"
+#include "agla/srv/fit_server.hpp"
+#include "agla/srv/shard.hpp"
+
+int main(int argc, char** argv) {
+	// --serve [socket-path]: answer binary fit requests on the socket, or on stdin/stdout without one
+	if (argc > 1 && std::string_view(argv[1]) == "--serve")
+		return argc > 2 ? agla::srv::serve_socket(argv[2]) : agla::srv::serve_stream(0, 1);
+
+	// --shard-worker <slice>: summary of one slice of a binary file on stdout, spawned by --sharded
+	if (argc > 1 && std::string_view(argv[1]) == "--shard-worker") {
+		const auto spec = agla::srv::parse_shard_arguments(argc - 2, argv + 2);
+		return spec.has_value() ? agla::srv::run_shard_worker(*spec, 1) : 2;
+	}
+
+	// --sharded <points.bin> <degree> [workers]: fit binary (x, y) doubles with local worker processes
+	if (argc > 1 && std::string_view(argv[1]) == "--sharded") {
+		agla::srv::sharded_fit_options options;
+
+		const auto degree = argc > 3 ? agla::srv::parse_size(argv[3]) : std::nullopt;
+		const auto workers = argc > 4 ? agla::srv::parse_size(argv[4]) : std::make_optional(options.workers);
+
+		if (argc > 5 || !degree || !workers || *workers == 0) {
+			std::fputs("Usage: --sharded <points.bin> <degree> [workers]\n", stderr);
+			return 2;
+		}
+
+		options.workers = *workers;
+
+		const agla::srv::shard_spec job { argv[2], 2, 0, std::numeric_limits<std::size_t>::max(), *degree };
+		const auto solution = agla::srv::sharded_fit("/proc/self/exe", job, options);
+
+		if (!solution.has_value()) {
+			std::fputs("Sharded fit failed\n", stderr);
+			return 1;
+		}
+
+		std::printf("Rows: %zu, residual norm: %g, condition number: %g, rank: %zu\n", solution->rows, solution->residual_norm, solution->condition_number, solution->rank);
+		std::cout << solution->x;
+		return 0;
+	}
 
-int main() {
 	std::random_device random_device;
 	std::mt19937 rng(random_device());
 	std::uniform_real_distribution<double> double_generator(-10.0, 10.0);
@@ -26,11 +66,7 @@ int main() {
 
 	std::size_t n = 5;
 
-	agla::mtx::matrix<double> a(m, std::vector<double>(n + 1, 1));
-
-	for (std::size_t i = 1; i <= n; ++i)
-		for (std::size_t q = 0; q < m; ++q)
-			a.get_unchecked(q).get_unchecked(i) = std::pow(a_buf[q], i);
+	const auto a = agla::lsq::vandermonde(a_buf, n);
 
 	std::puts("A:");
 	std::cout << a;
@@ -38,21 +74,10 @@ int main() {
 	std::puts("B:");
 	std::cout << b;
 
-	const auto at = a.transposed();
-	const auto at_a = agla::mtx::square_matrix<double>::from_matrix_unchecked(at.mul_unchecked(a));
-
-	std::puts("A_T*A:");
-	std::cout << at_a;
-
-	const auto at_a_inv = at_a.inversed_unchecked();
-	std::puts("(A_T*A)^-1:");
-	std::cout << at_a_inv;
-
-	const auto at_b = at.mul_unchecked(b);
-	std::puts("A_T*b:");
-	std::cout << at_b;
+	const auto solution = agla::lsq::least_squares(a, b).value();
+	std::printf("Solver: %s, condition estimate: %g, rank: %zu\n", agla::lsq::name(solution.method), solution.condition_estimate, solution.rank);
 
-	const auto x = agla::mtx::column_vector<double>::from_matrix_unchecked(at_a_inv.mul_unchecked(at_b));
+	const auto& x = solution.x;
 	std::puts("x~:");
 	std::cout << x;
 